@@ -0,0 +1,65 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <new>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Bump allocator for many small objects of the same type.
+// Objects are placed back to back into big blocks that never move, so pointers to them stay valid.
+// Nothing is freed one by one, everything goes at once when the arena dies.
+template<typename T>
+class Arena{
+public:
+    // How many objects fit into one block.
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    vector<T*> Blocks;
+    size_t Block_Used = BLOCK_SIZE;
+
+    Arena(){}
+
+    ~Arena(){
+        Clear();
+    }
+
+    // The arena owns its objects, so it cannot be shared.
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template<typename... Args>
+    T* New(Args&&... args){
+        if (Block_Used == BLOCK_SIZE){
+            Blocks.push_back(static_cast<T*>(::operator new(sizeof(T) * BLOCK_SIZE)));
+            Block_Used = 0;
+        }
+
+        return new (Blocks.back() + Block_Used++) T(forward<Args>(args)...);
+    }
+
+    size_t Size(){
+        if (Blocks.size() == 0)
+            return 0;
+
+        return (Blocks.size() - 1) * BLOCK_SIZE + Block_Used;
+    }
+
+    // Destroys all the objects and gives the blocks back in one go.
+    void Clear(){
+        for (size_t i = 0; i < Blocks.size(); i++){
+            size_t Used = i + 1 == Blocks.size() ? Block_Used : BLOCK_SIZE;
+
+            for (size_t j = 0; j < Used; j++)
+                Blocks[i][j].~T();
+
+            ::operator delete(Blocks[i]);
+        }
+
+        Blocks.clear();
+        Block_Used = BLOCK_SIZE;
+    }
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef _ARRAY_VIEW_H_
+#define _ARRAY_VIEW_H_
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Read only window into an array that is owned by something else, like a vector or a section of a memory mapped file.
+// Indexes just like the vector would, so the same code can walk either.
+template<typename T>
+class Array_View{
+public:
+    using Type = T;
+
+    const T* Data = nullptr;
+    size_t Count = 0;
+
+    Array_View(){}
+    Array_View(const T* Data, size_t Count) : Data(Data), Count(Count) {}
+    Array_View(const vector<T>& Vector) : Data(Vector.data()), Count(Vector.size()) {}
+
+    const T& operator[](size_t Index) const{
+        return Data[Index];
+    }
+
+    size_t size() const{
+        return Count;
+    }
+
+    const T* begin() const{
+        return Data;
+    }
+
+    const T* end() const{
+        return Data + Count;
+    }
+};
+
+#endif
@@ -1,4 +1,7 @@
 #include "DMC.h"
+#include "Mapped_File.h"
+#include "Parallel.h"
+#include "Tokenizer.h"
 
 #define _USE_MATH_DEFINES
 
@@ -8,79 +11,180 @@
 #include <cmath>
 #include <algorithm>
 #include <vector>
+#include <limits>
 
 using namespace std;
 
 
 Language::Language(string File_Name){
-    ifstream File(File_Name);
-
     // Set the language name as the file name
     // Also cut all the folders and file endings from the file name before assigning it to the name.
     Language_Name = File_Name.substr(File_Name.find_last_of("/\\") + 1);
     Language_Name = Language_Name.substr(0, Language_Name.find_last_of("."));
 
+    Mapped_File Mapped(File_Name);
 
-    if (!File.is_open()){
-        cout << "Error while opening file" << endl;
-    }
+    if (Mapped.Is_Open()){
+        // Tokenize straight from the mapped pages, so the Raw_Buffer never gets built.
+        // The whole file is at hand, so the chain can be built from it in parallel.
+        Concat_Raw_Buffer(Mapped.View());
 
-    string Line;
-    while(getline(File, Line)){
-        Raw_Buffer += Line + " ";
+        Apply_Markov_To_Buffer();
     }
-    File.close();
+    else{
+        // Fall back to streaming the file line by line, when it cannot be mapped.
+        ifstream File(File_Name);
+
+        if (!File.is_open()){
+            cout << "Error while opening file" << endl;
+        }
 
-    Concat_Raw_Buffer();
+        string Line;
+        while(getline(File, Line)){
+            Feed(Line);
+            Feed(" ");
+        }
+        File.close();
 
-    Apply_Markov_To_Buffer();
+        Finalize();
+    }
 }
 
 Word* Language::Find(int x, int y){
-    return &Cut_Buffer[x + y * Width];
+    return Markov_Buffer[Cut_Buffer[x + (size_t)y * Width]];
+}
+
+Word* Language::Find(string_view w){
+    uint32_t ID = Dictionary.Find(w);
+
+    // Words can be interned before the Markov chain gets to them.
+    if (ID >= Markov_Buffer.size())
+        return nullptr;
+
+    return Markov_Buffer[ID];
 }
 
 void Language::Concat_Raw_Buffer(){
-    string Current_Word = "";
-
-    for (int i = 0; i < Raw_Buffer.size(); i++){
-        if (
-            Raw_Buffer[i] == ' ' || 
-            Raw_Buffer[i] == ',' || 
-            Raw_Buffer[i] == ':' || 
-            Raw_Buffer[i] == '(' || 
-            Raw_Buffer[i] == ')' ||
-            Raw_Buffer[i] == '.' || 
-            Raw_Buffer[i] == '!' || 
-            Raw_Buffer[i] == '?' || 
-            Raw_Buffer[i] == '"' || 
-            Raw_Buffer[i] == '\'' || 
-            Raw_Buffer[i] == '-' || 
-            Raw_Buffer[i] == '+' || 
-            Raw_Buffer[i] == '*' || 
-            Raw_Buffer[i] == ';' || 
-            Raw_Buffer[i] == '[' || 
-            Raw_Buffer[i] == ']' || 
-            Raw_Buffer[i] == '{' || 
-            Raw_Buffer[i] == '}' || 
-            Raw_Buffer[i] == '\t'
-        ){
-            if (Current_Word.size() > 0)
-                Cut_Buffer.push_back(Word(Current_Word));
-
-            if (Raw_Buffer[i] != ' ')
-                Cut_Buffer.push_back(Word(Raw_Buffer[i]));
-
-            Next_Word:;
-            Current_Word = "";
+    Concat_Raw_Buffer(Raw_Buffer);
+}
+
+void Language::Concat_Raw_Buffer(string_view Buffer){
+    unsigned Threads = Thread_Count();
+
+    // Every region should be big enough to be worth a thread.
+    size_t Regions = max<size_t>(1, min<size_t>(Threads, Buffer.size() / (1 << 20)));
+
+    if (Regions == 1){
+        string_view Last_Word = Tokenize(Buffer, [this](string_view w){
+            Cut_Buffer.push_back(Dictionary.Intern(w));
+        });
+
+        if (Last_Word.size() > 0){
+            Cut_Buffer.push_back(Dictionary.Intern(Last_Word));
         }
-        else{
-            Current_Word += Raw_Buffer[i];
+
+        return;
+    }
+
+    // Split the buffer evenly, but move every split forward onto the next delimiter, so no word is cut in two.
+    const char* Begin = Buffer.data();
+    const char* End = Begin + Buffer.size();
+
+    vector<const char*> Splits(Regions + 1);
+    Splits[0] = Begin;
+    Splits[Regions] = End;
+
+    for (size_t r = 1; r < Regions; r++){
+        Splits[r] = Find_Delimiter(max(Splits[r - 1], Begin + Buffer.size() * r / Regions), End);
+    }
+
+    // Each region is tokenized into ids of its own little vocabulary.
+    vector<Vocabulary> Local_Dictionaries(Regions);
+    vector<vector<uint32_t>> Local_Buffers(Regions);
+
+    Parallel_For(Regions, [&](unsigned, size_t First, size_t Last){
+        for (size_t r = First; r < Last; r++){
+            Vocabulary& Local_Dictionary = Local_Dictionaries[r];
+            vector<uint32_t>& Local_Buffer = Local_Buffers[r];
+
+            string_view Last_Word = Tokenize(string_view(Splits[r], Splits[r + 1] - Splits[r]), [&](string_view w){
+                Local_Buffer.push_back(Local_Dictionary.Intern(w));
+            });
+
+            // Any region can end on a word, the splits sit on delimiters so the word is always whole and is emitted as is.
+            if (Last_Word.size() > 0){
+                Local_Buffer.push_back(Local_Dictionary.Intern(Last_Word));
+            }
+        }
+    }, 1, Threads);
+
+    // Interning the local vocabularies in region order hands out the same ids as tokenizing the whole buffer in one go would.
+    // This is the only part that is not parallel, but it only touches each regions unique words.
+    vector<vector<uint32_t>> Local_To_Global(Regions);
+    vector<size_t> Offsets(Regions + 1, Cut_Buffer.size());
+
+    for (size_t r = 0; r < Regions; r++){
+        Vocabulary& Local_Dictionary = Local_Dictionaries[r];
+
+        for (uint32_t ID = 0; ID < Local_Dictionary.Size(); ID++){
+            Local_To_Global[r].push_back(Dictionary.Intern(Local_Dictionary.Get(ID), Local_Dictionary.Hashes[ID]));
+        }
+
+        Offsets[r + 1] = Offsets[r] + Local_Buffers[r].size();
+    }
+
+    Cut_Buffer.resize(Offsets[Regions]);
+
+    // Translate the local ids and put the regions back together in order.
+    Parallel_For(Regions, [&](unsigned, size_t First, size_t Last){
+        for (size_t r = First; r < Last; r++){
+            for (size_t i = 0; i < Local_Buffers[r].size(); i++){
+                Cut_Buffer[Offsets[r] + i] = Local_To_Global[r][Local_Buffers[r][i]];
+            }
         }
+    }, 1, Threads);
+}
+
+void Language::Feed(string_view Chunk){
+    auto Ingest = [this](string_view w){
+        uint32_t ID = Append_To_Markov(w);
+
+        if (Keep_Cut_Buffer)
+            Cut_Buffer.push_back(ID);
+    };
+
+    // Finish the word that the previus chunk cut in half.
+    if (Partial_Word.size() > 0){
+        const char* Word_End = Find_Delimiter(Chunk.data(), Chunk.data() + Chunk.size());
+
+        Partial_Word.append(Chunk.data(), Word_End - Chunk.data());
+        Chunk.remove_prefix(Word_End - Chunk.data());
+
+        // The whole chunk was still the same word.
+        if (Chunk.size() == 0)
+            return;
+
+        Ingest(Partial_Word);
+        Partial_Word.clear();
     }
-    if (Current_Word != ""){
-        Cut_Buffer.push_back(Word(Current_Word));
+
+    Partial_Word = Tokenize(Chunk, Ingest);
+}
+
+void Language::Finalize(){
+    // The last word has nothing after it to end it.
+    if (Partial_Word.size() > 0){
+        uint32_t ID = Append_To_Markov(Partial_Word);
+
+        if (Keep_Cut_Buffer)
+            Cut_Buffer.push_back(ID);
+
+        Partial_Word.clear();
     }
+
+    Layout_Cut_Buffer();
+
+    Finalize_Instance_Countters();
 }
 
 // This function return 0-1f similiarity of two words. 
@@ -129,80 +233,164 @@ void Language::Apply_Markov_To_Buffer(){
         return;
     }
 
-    Width = floor(sqrt(Cut_Buffer.size()));
-
-    // Apply indicies to the cut buffer, since it is te only liquid 2D map.
-    for (int y = 0; y < Width; y++){
-        for (int x = 0; x < Width; x++){
-            Cut_Buffer[x + y * Width].Position = {x, y};
-        }
+    // Make the Markov words up front, so the threads below only count.
+    for (uint32_t ID = 0; ID < Dictionary.Size(); ID++){
+        Get_Markov_Word(ID);
     }
 
-    //Markov_Buffer.push_back(&Cut_Buffer[0]);
-    Fast_Markov[Cut_Buffer[0].Data] = &Cut_Buffer[0];
+    // Every thread counts the words and word pairs of its own shard of the cut buffer.
+    // A pair crossing into the next shard belongs to the shard of its second word, so each thread also looks one word back.
+    unsigned Threads = Thread_Count();
 
-    // First group by one identifier.
-    for (int i = 1; i < Cut_Buffer.size(); i++){
+    vector<Edge_Counter> Local_Transitions(Threads);
+    vector<vector<uint32_t>> Local_Instances(Threads);
 
-        Word* Current = nullptr;
+    Parallel_For(Cut_Buffer.size(), [&](unsigned Thread, size_t Begin, size_t End){
+        Edge_Counter& Edges = Local_Transitions[Thread];
+        vector<uint32_t>& Counted = Local_Instances[Thread];
 
-        // If this word has already been defined
-        Word* tmp = Fast_Markov[Cut_Buffer[i].Data];
-        if (tmp){
-            Current = tmp;
-        }
-        else{
-            // If not then make a new one and point to it.
-            //Markov_Buffer.push_back(new Word(Cut_Buffer[i]));
-            Fast_Markov[Cut_Buffer[i].Data] = new Word(Cut_Buffer[i]);
-            //Current = Markov_Buffer.back();
-            Current = Fast_Markov[Cut_Buffer[i].Data];
-            Current->Instances++;
-        }
+        Counted.assign(Dictionary.Size(), 0);
 
-        Word* Previus = Fast_Markov[Cut_Buffer[i - 1].Data];
+        for (size_t i = Begin; i < End; i++){
+            Counted[Cut_Buffer[i]]++;
 
-        if (Current->Data == Previus->Data){
-            continue;
+            // The cut buffer is a fresh stream of its own, so its first word has nothing to chain from.
+            if (i > 0 && Cut_Buffer[i - 1] != Cut_Buffer[i])
+                Edges.Add(Cut_Buffer[i - 1], Cut_Buffer[i]);
         }
+    }, 1 << 16, Threads);
 
-        if (Previus->Get_Next(Current->Data)){
-            Previus->Get_Next(Current->Data)->first++;
-        }
-        else{
-            Previus->Next_Chain.push_back({0, Current});
+    // Each thread merges its own share of the shards from all the local counters.
+    Parallel_For(Edge_Counter::SHARDS, [&](unsigned, size_t First, size_t Last){
+        for (size_t Shard = First; Shard < Last; Shard++){
+            for (auto& Edges : Local_Transitions){
+                Transitions.Merge(Edges, Shard);
+            }
         }
+    }, 1, Threads);
 
-        if (Current->Get_Prev(Previus->Data)){
-            Current->Get_Prev(Previus->Data)->first++;
-        }
-        else{
-            Current->Previus_Chain.push_back({0, Previus});
+    Parallel_For(Dictionary.Size(), [&](unsigned, size_t First, size_t Last){
+        for (auto& Counted : Local_Instances){
+            // Threads that got no shard never sized their counts.
+            if (Counted.size() == 0)
+                continue;
+
+            for (size_t ID = First; ID < Last; ID++){
+                Instances[ID] += Counted[ID];
+            }
         }
+    }, 1 << 14, Threads);
 
-    }
+    // Later Feeds continue from the end of the cut buffer.
+    Previus_Word = Markov_Buffer[Cut_Buffer.back()];
+
+    Layout_Cut_Buffer();
 
     Finalize_Instance_Countters();
 }
 
-// Changes the countting to probabilistics.
-void Language::Finalize_Instance_Countters(){
-    for (auto& i : Fast_Markov){
-        int sum = 0;
-        for (auto& [count, next_word] : i.second->Next_Chain){
-            sum += count;
-        }
-        for (auto& [count, next_word] : i.second->Next_Chain){
-            count /= sum;
-        }
-        sum = 0;
-        for (auto& [count, prev_word] : i.second->Previus_Chain){
-            sum += count;
-        }
-        for (auto& [count, prev_word] : i.second->Previus_Chain){
-            count /= sum;
+Word* Language::Get_Markov_Word(uint32_t ID){
+    if (ID >= Markov_Buffer.size()){
+        Markov_Buffer.resize(ID + 1, nullptr);
+
+        Positions.resize(ID + 1);
+        Instances.resize(ID + 1, 0);
+        Importance.resize(ID + 1, 1);
+        Complexity.resize(ID + 1, 0);
+    }
+
+    // If this word has already been defined
+    Word*& Current = Markov_Buffer[ID];
+
+    if (!Current){
+        // If not then make a new one and point to it.
+        Current = Markov_Words.New(ID, Dictionary.Get(ID));
+    }
+
+    return Current;
+}
+
+uint32_t Language::Append_To_Markov(string_view Token){
+    return Append_To_Markov(Dictionary.Intern(Token));
+}
+
+uint32_t Language::Append_To_Markov(uint32_t ID){
+    Word* Current = Get_Markov_Word(ID);
+    Instances[ID]++;
+
+    Word* Previus = Previus_Word;
+    Previus_Word = Current;
+
+    // The first word of the stream has nothing to chain from.
+    if (!Previus || Current == Previus){
+        return ID;
+    }
+
+    Transitions.Add(Previus->ID, ID);
+
+    return ID;
+}
+
+void Language::Layout_Cut_Buffer(){
+    Width = floor(sqrt(Cut_Buffer.size()));
+
+    // The cut buffer is the only liquid 2D map, and every Markov word sits where it first occured.
+    // So walk backwards and let the earliest occurence win.
+    for (int y = Width - 1; y >= 0; y--){
+        for (int x = Width - 1; x >= 0; x--){
+            Positions[Cut_Buffer[x + (size_t)y * Width]] = {x, y};
         }
     }
+
+    Index_Cells();
+}
+
+void Language::Index_Cells(){
+    // The cells are stored as uint32_t, which fits any map of up to 65535 x 65535, but the count itself is multiplied in size_t.
+    size_t Cell_Count = (size_t)Width * Width;
+
+    Cell_Offsets.assign(Dictionary.Size() + 1, 0);
+    Cells.resize(Cell_Count);
+
+    for (size_t Cell = 0; Cell < Cell_Count; Cell++){
+        Cell_Offsets[Cut_Buffer[Cell] + 1]++;
+    }
+
+    for (size_t ID = 0; ID < Dictionary.Size(); ID++){
+        Cell_Offsets[ID + 1] += Cell_Offsets[ID];
+    }
+
+    // Every word fills its range front to back, so the cells of a word stay in map order.
+    vector<uint32_t> Cursor(Cell_Offsets.begin(), Cell_Offsets.end() - 1);
+
+    for (size_t Cell = 0; Cell < Cell_Count; Cell++){
+        Cells[Cursor[Cut_Buffer[Cell]]++] = (uint32_t)Cell;
+    }
+}
+
+// Turns the counted transitions into the Markov chain matrices.
+// The raw counts stay, and the probabilistics are computed next to them.
+void Language::Finalize_Instance_Countters(){
+    Next_Chain.Build(Transitions, Dictionary.Size(), false);
+    Previus_Chain.Build(Transitions, Dictionary.Size(), true);
+
+    Next_Chain.Normalize();
+    Previus_Chain.Normalize();
+
+    Previus_Chain.Link_Mirror(Next_Chain);
+
+    // Only the generation walks forward through the chain, so only that needs the O(1) sampling.
+    Next_Chain.Build_Alias();
+
+    Chain_Generation++;
+}
+
+void Language::Update_Landmarks(Path_Finder& Paths){
+    if (Guides_Generation == Chain_Generation)
+        return;
+
+    Guides.Build(Next_Chain, Previus_Chain, Most_Used_Word(Instances), Landmark_Count, Paths);
+    Guides_Generation = Chain_Generation;
 }
 
 void Teller::Factory(){
@@ -228,48 +416,92 @@ void Teller::Centric_Gradient(){
 
     // Using Center method.
     // With of the gradient map is same as the Width.
-    Gradient_Map.resize(Speaks->Width * Speaks->Width);
+    int Width = Speaks->Width;
 
-    int Center_X = Speaks->Width / 2;
-    int Center_Y = Speaks->Width / 2;
+    Vector2 Center = {Width / 2, Width / 2};
 
     // This is the max distance from the center.
-    int Max_Distance = Speaks->Width / 2;
+    // On an even Width the center leans to the bottom right, so the last ring is partly outside the map.
+    int Max_Distance = Width / 2;
 
-    vector<int> Ordered_Instances;
+    // The most instances having words come first, and fill the rings from the center out.
+    Fill_Gradient(IDS::CENTRIC_GRADIENT, Order_By_Instances(Speaks->Instances), [&](auto Visit){
+        // Every ring is walked once, so this is linear to the map size.
+        for (int i = 0; i <= Max_Distance; i++){
+            for (auto index : Square_Ring(Center, i)){
 
-    // Order the Cut_Buffer, where the most instances having words are first.
-    for (int i = 0; i < Speaks->Cut_Buffer.size(); i++){
-        Ordered_Instances.push_back(i);
-    }
+                // If the index is out of bounds, then skip it.
+                if (index.X < 0 || index.Y < 0 || index.X >= Width || index.Y >= Width)
+                    continue;
 
-    // Sort the ordered instances.
-    sort(Ordered_Instances.begin(), Ordered_Instances.end(), [this](int a, int b){
-        return Speaks->Cut_Buffer[a].Instances > Speaks->Cut_Buffer[b].Instances;
+                Visit(index);
+            }
+        }
     });
+}
 
-    int Order_Index = 0;
-    for (int i = 0; i < Max_Distance; i++){
-        for (auto index : Get_Surrounding({0, 0}, i)){
+vector<uint32_t> Order_By_Instances(const vector<int>& Instances){
+    size_t Count = Instances.size();
 
-            // If the index is out of bounds, then skip it.
-            if (index.X > Max_Distance || index.Y > Max_Distance)
-                continue;
+    vector<uint32_t> Order(Count);
+    vector<uint32_t> Keys(Count);
 
-            Transformation Current_Transform;
-            Current_Transform.Origin = Speaks->Cut_Buffer[
-                Ordered_Instances[Order_Index++]
-            ].Position;
+    int Max_Instances = 0;
+    for (int Instance : Instances){
+        Max_Instances = max(Max_Instances, Instance);
+    }
 
-            Current_Transform.Target = index;
+    // Flipping the counts around the biggest one turns the ascending sort into a descending one, and keeps it stable.
+    for (size_t ID = 0; ID < Count; ID++){
+        Order[ID] = (uint32_t)ID;
+        Keys[ID] = (uint32_t)(Max_Instances - Instances[ID]);
+    }
 
-            // Save the transformation suggestions.
-            Gradient_Map[index.Y * Speaks->Width + index.X].Add_Transform(
-                IDS::CENTRIC_GRADIENT, 
-                Current_Transform
-            );
+    vector<uint32_t> Next_Order(Count);
+    vector<uint32_t> Next_Keys(Count);
+
+    // One histogram of 256 digits per shard, Parallel_For splits the same Count the same way on every call.
+    unsigned Threads = Thread_Count();
+    vector<size_t> Histograms(Threads * 256);
+
+    for (int Shift = 0; Shift < 32 && ((uint32_t)Max_Instances >> Shift) != 0; Shift += 8){
+        fill(Histograms.begin(), Histograms.end(), 0);
+
+        Parallel_For(Count, [&](unsigned Thread, size_t Begin, size_t End){
+            size_t* Histogram = &Histograms[Thread * 256];
+
+            for (size_t i = Begin; i < End; i++){
+                Histogram[Keys[i] >> Shift & 0xFF]++;
+            }
+        }, 1 << 14, Threads);
+
+        // Turn the counts into where each shard starts writing each digit, digit by digit and shard by shard in order.
+        size_t Offset = 0;
+        for (int Digit = 0; Digit < 256; Digit++){
+            for (unsigned Thread = 0; Thread < Threads; Thread++){
+                size_t Digit_Count = Histograms[Thread * 256 + Digit];
+
+                Histograms[Thread * 256 + Digit] = Offset;
+                Offset += Digit_Count;
+            }
         }
+
+        Parallel_For(Count, [&](unsigned Thread, size_t Begin, size_t End){
+            size_t* Cursor = &Histograms[Thread * 256];
+
+            for (size_t i = Begin; i < End; i++){
+                size_t To = Cursor[Keys[i] >> Shift & 0xFF]++;
+
+                Next_Order[To] = Order[i];
+                Next_Keys[To] = Keys[i];
+            }
+        }, 1 << 14, Threads);
+
+        swap(Order, Next_Order);
+        swap(Keys, Next_Keys);
     }
+
+    return Order;
 }
 
 void Teller::Cubical_Dalmian_Gradient(){
@@ -278,14 +510,71 @@ void Teller::Cubical_Dalmian_Gradient(){
         Generates a n'th dimensional array to hold all the words.
         all keywords have their own corner.
     */
-    vector<Word*> Keywords = Get_Keywords();
+    vector<uint32_t> Keywords = Get_Keywords();
+
+    Cube.Build(Speaks->Next_Chain, Speaks->Previus_Chain, Keywords, Speaks->Dictionary.Size());
+
+    int Width = Speaks->Width;
+
+    // The cube can't be drawn on the 2D map as is, so the words are walked in their Morton order, and fill the map in the 2D Morton order.
+    // Words close to each other in the cube then mostly stay close on the map too.
+
+    // Pulls the every other bit of the code together, which is the x of a 2D Morton code, or the y when shifted by one.
+    auto Compact = [](uint64_t Code){
+        uint32_t Result = 0;
+
+        for (int b = 0; b < 32; b++){
+            Result |= (uint32_t)(Code >> (2 * b) & 1) << b;
+        }
+
+        return (int)Result;
+    };
+
+    // The 2D Morton codes cover a power of two square, the cells outside of the map are skipped.
+    uint64_t Side = 1;
+    while (Side < (uint64_t)Width){
+        Side *= 2;
+    }
+
+    Fill_Gradient(IDS::CUBICAL_DALMIAN_GRADIENT, Cube.Words, [&](auto Visit){
+        for (uint64_t Code = 0; Code < Side * Side; Code++){
+            Vector2 index = {Compact(Code), Compact(Code >> 1)};
 
+            if (index.X >= Width || index.Y >= Width)
+                continue;
+
+            Visit(index);
+        }
+    });
 }
 
 void Teller::Spherical_Dalmian_Gradient(){
+    vector<uint32_t> Keywords = Get_Keywords();
+
+    uint32_t Point_Count = max<uint32_t>(Sphere_Resolution, 4 * Keywords.size());
 
+    Sphere.Build(Speaks->Next_Chain, Speaks->Previus_Chain, Keywords, Speaks->Dictionary.Size(), Point_Count);
 
+    int Width = Speaks->Width;
+
+    // The buckets of the sphere go by latitude and then longitude, so walking the words of their points in bucket order unwraps the sphere like a world map.
+    vector<uint32_t> Ordered_Words;
+    Ordered_Words.reserve(Sphere.Words.size());
+
+    for (auto Point : Sphere.Bucket_Points){
+        for (auto ID : Sphere.Find(Point)){
+            Ordered_Words.push_back(ID);
+        }
+    }
 
+    // The map is then filled row by row.
+    Fill_Gradient(IDS::SPHERICAL_DALMIAN_GRADIENT, Ordered_Words, [&](auto Visit){
+        for (int y = 0; y < Width; y++){
+            for (int x = 0; x < Width; x++){
+                Visit(Vector2(x, y));
+            }
+        }
+    });
 }
 
 vector<Vector2> Teller::Get_Circle_Perimeter_Indicies(int Radius){
@@ -319,10 +608,10 @@ float Teller::Get_Symmetrical_Spacing_On_Circle_Perimeter(int Point_Count){
 }
 
 void Teller::Circular_Dalmian_Gradient(){
-    vector<Word*> Keywords = Get_Keywords();
+    vector<uint32_t> Keywords = Get_Keywords();
 
     // We need to get the circle radius needed to house the square area in the circle.
-    int Square_Area = Speaks->Width * Speaks->Width;  
+    size_t Square_Area = (size_t)Speaks->Width * Speaks->Width;
 
     // Get the radius of the circle from the square area
     float Radius = sqrt(Square_Area / M_PI);
@@ -343,11 +632,11 @@ void Teller::Circular_Dalmian_Gradient(){
         // If the radian difference is bigger than the radiant difference, then we can use this point.
         if (Radian_Difference > Radian_Spacing){
 
-            // Save the transformation suggestions.
-            Gradient_Map[perimeter_point.Y * Speaks->Width + perimeter_point.X].Add_Transform(
+            // Save the transformation suggestions, the points outside of the map are left out.
+            Gradient_Map.Add_Transform(
                 IDS::CIRCULAR_DALMIAN_GRADIENT, 
                 {
-                    Keywords[Current_Keyword_Index]->Position,
+                    Speaks->Positions[Keywords[Current_Keyword_Index]],
                     perimeter_point
                 }
             );
@@ -361,70 +650,61 @@ void Teller::Circular_Dalmian_Gradient(){
 }
 
 void Teller::Calculate_Importance_Scaling(){
+    vector<float>& Importance = Speaks->Importance;
+    const vector<int>& Complexity = Speaks->Complexity;
+    const vector<uint32_t>& Next_Offsets = Speaks->Next_Chain.Offsets;
+    const vector<uint32_t>& Previus_Offsets = Speaks->Previus_Chain.Offsets;
+
+    size_t Word_Count = Importance.size();
+    float Total = (float)Speaks->Cut_Buffer.size();
+
     // Calculate importance scaling for each word
-    for (auto& i : Speaks->Fast_Markov){
-        i.second->Importance = i.second->Complexity + i.second->Next_Chain.size() + i.second->Previus_Chain.size();
+    // The degrees are the differences of the neighbouring row offsets, so this whole pass is straight array arithmetic.
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        uint32_t Degree = (Next_Offsets[ID + 1] - Next_Offsets[ID]) + (Previus_Offsets[ID + 1] - Previus_Offsets[ID]);
 
-        i.second->Importance /= (float)Speaks->Cut_Buffer.size();
+        Importance[ID] = (Complexity[ID] + Degree) / Total;
     }
 
     // Now we need to normalize the importance scaler.
     float Max = 0;
 
-    for (auto& i : Speaks->Fast_Markov){
-        if (i.second->Importance > Max)
-            Max = i.second->Importance;
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        Max = max(Max, Importance[ID]);
     }
 
+    // A language without a single link has nothing to scale.
+    if (Max == 0)
+        return;
+
     // Apply the normalization.
-    for (auto& i : Speaks->Fast_Markov){
-        i.second->Importance /= Max;
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        Importance[ID] /= Max;
     }
 }
 
-vector<Word*> Teller::Get_Keywords(){
+vector<uint32_t> Teller::Get_Keywords(){
     // All words that have the Importance Scaler above 0.5 pass as keywords.
-    vector<Word*> Keywords;
+    vector<uint32_t> Keywords;
 
-    for (auto& i : Speaks->Fast_Markov){
-        if (i.second->Importance > 0.5){
-            Keywords.push_back(i.second);
+    for (uint32_t ID = 0; ID < Speaks->Importance.size(); ID++){
+        if (Speaks->Importance[ID] > 0.5){
+            Keywords.push_back(ID);
         }
     }
-}
 
-template<typename T>
-bool Find(T obj, vector<T> list){
-    for (auto i : list){
-        if (obj() == i())
-            return true;
-    }
-
-    return false;
+    return Keywords;
 }
 
-// Retuns a growing rectangle of indicies surrounding the area that is calculated from the distance from the center.
-// Distance from center when 0, returns 2x2 center indicies.
-// Distance from center when 1, returns the indicies surrounding the 2x2 indicies, that being 12 indicies.
-// Distance from center when 2, returns the indicies surrounding the 12 indicies, the being 19 indicies.
-// Distance from center when 3, returns the indicies surrounding the 19 indicies, the being 28 indicies.
-// Distance from center when 4, returns the indicies surrounding the 28 indicies, the being 39 indicies.
-// The returning indicies grow by the factor of numbers non divisible by 2, those being 7, 9, 11, ...
-// So the distance from the center by 6, returns indicies surrounding the 39 indicies, the being 52 indicies.
 vector<Vector2> Teller::Get_Surrounding(Vector2 origin, int Distance_From_Center){
     vector<Vector2> indices;
-    for (int d = 0; d <= Distance_From_Center; d++) {
-        for (int i = origin.X - d; i <= origin.X + d; i++) {
-            for (int j = origin.Y - d; j <= origin.Y + d; j++) {
-                if (abs(i - origin.X) == d || abs(j - origin.Y) == d) {
-                    if (Find(Vector2(i, j), indices))
-                        continue;
-                    
-                    indices.push_back(Vector2(i, j));
-                }
-            }
+
+    for (int d = 0; d <= Distance_From_Center; d++){
+        for (auto index : Square_Ring(origin, d)){
+            indices.push_back(index);
         }
     }
+
     return indices;
 }
 
@@ -432,10 +712,10 @@ void Language::Output(string File_Name){
     ofstream File(File_Name);
 
     // Prints the markov chains content with "name": {links, ...}
-    for (auto w : Fast_Markov){
-        File << w.first << ": {";
-        for (auto c : w.second->Next_Chain){
-            File << c.second->Data << ", ";
+    for (auto w : Markov_Buffer){
+        File << w->Data << ": {";
+        for (uint32_t c = Next_Chain.Offsets[w->ID]; c < Next_Chain.Offsets[w->ID + 1]; c++){
+            File << Dictionary.Get(Next_Chain.Targets[c]) << ", ";
         }
         File << "}" << endl;
     }
@@ -487,25 +767,54 @@ vector<pair<int, int>> Teller::Get_Surrounding(int x, int y){
 // Note, negative weights are good words and the Teller will cascade towards them.
 // Thus positive wieghts are bad words that the Teller tries to avoid.
 void Teller::Init_Weight(vector<pair<Weight,string>> weights){
-    if (Weights.size() == 0){
-        Weights.resize(Speaks->Width * Speaks->Width);
+    vector<pair<Weight, uint32_t>> Weighted_IDs;
+
+    // Words the language has never seen cannot be on the map.
+    for (auto& w : weights){
+        uint32_t ID = Speaks->Dictionary.Find(w.second);
+
+        if (ID != Vocabulary::NOT_FOUND)
+            Weighted_IDs.push_back({w.first, ID});
+    }
+
+    Apply_Weights(Weights, Speaks->Width, Diffuse, Diffusion, Speaks->Cell_Offsets, Speaks->Cells, Weighted_IDs);
+}
+
+void Apply_Weights(vector<Weight>& Weights, int Width, float Diffuse, Diffusion_Mode Mode, Array_View<uint32_t> Cell_Offsets, Array_View<uint32_t> Cells, const vector<pair<Weight, uint32_t>>& Weighted_IDs){
+    // The weights of a map of another size, like one from before more text was fed, don't line up with the cells anymore.
+    if (Weights.size() != (size_t)Width * Width){
+        Weights.assign((size_t)Width * Width, Weight());
     }
 
     vector<pair<int, int>> Points_Of_Interest;
 
-    for (int y = 0; y < Speaks->Width; y++){
-        for (int x = 0; x < Speaks->Width; x++){
-            for (auto& w : weights){
-                if (w.second == Speaks->Fast_Markov[Speaks->Cut_Buffer[y * Speaks->Width + x].Data]->Data){
-                    Weights[y * Speaks->Width + x].Intensity = w.first.Intensity;
-                    Points_Of_Interest.push_back({x, y});
-                }
-            }
+    for (auto& w : Weighted_IDs){
+        for (uint32_t i = Cell_Offsets[w.second]; i < Cell_Offsets[w.second + 1]; i++){
+            uint32_t Cell = Cells[i];
+
+            Weights[Cell].Intensity = w.first.Intensity;
+            Points_Of_Interest.push_back({(int)(Cell % Width), (int)(Cell / Width)});
         }
     }
 
+    if (Mode == Diffusion_Mode::CONVOLUTION){
+        Convolve_Weights(Weights, Width, Diffuse, Points_Of_Interest);
+        return;
+    }
+
+    // Every point spreads the weight it was given, not what the points before it have already added into its cell.
+    // So the order of the weights does not matter.
+    vector<float> Intensities;
+    Intensities.reserve(Points_Of_Interest.size());
+
     for (auto& p : Points_Of_Interest){
-        Diffuse_Around_Point_Of_Interest(p.first, p.second, p.first, p.second);
+        Intensities.push_back(Weights[(size_t)p.second * Width + p.first].Intensity);
+    }
+
+    Weight_Diffuser Diffuser(Width);
+
+    for (size_t i = 0; i < Points_Of_Interest.size(); i++){
+        Diffuser.Spread(Weights, Diffuse, Points_Of_Interest[i].first, Points_Of_Interest[i].second, Intensities[i]);
     }
 }
 
@@ -515,25 +824,280 @@ bool Around(float a, int b){
     return (max(a, (float)b) - min(a, (float)b)) < Threshold;
 }
 
-void Teller::Diffuse_Around_Point_Of_Interest(int x, int y, int parent_x, int parent_y){
-    if (Around(Weights[y * Speaks->Width + x].Intensity, 0))
-        return;
+void Teller::Diffuse_Around_Point_Of_Interest(int x, int y){
+    Weight_Diffuser(Speaks->Width).Spread(Weights, Diffuse, x, y, Weights[(size_t)y * Speaks->Width + x].Intensity);
+}
 
-    for (auto& s : Get_Surrounding(x, y)){
-        if (s.first == parent_x && s.second == parent_y)
-            continue;
+void Weight_Diffuser::Spread(vector<Weight>& Weights, float Diffuse, int x, int y, float Intensity){
+    uint32_t Origin = (uint32_t)((size_t)y * Width + x);
+
+    Queue.clear();
+    Queue.push_back(Origin);
+    Visited[Origin / 64] |= 1ull << (Origin % 64);
+
+    // The cells of the current ring are Queue[Ring_Begin, Ring_End).
+    size_t Ring_Begin = 0;
+    size_t Ring_End = 1;
+
+    // Rings keep coming until the weight has faded, or the whole map is covered.
+    while (!Around(Intensity, 0) && Ring_Begin < Ring_End){
+        Intensity *= Diffuse;
+
+        for (size_t i = Ring_Begin; i < Ring_End; i++){
+            int Cell_X = Queue[i] % Width;
+            int Cell_Y = Queue[i] / Width;
+
+            auto Reach = [&](int Next_X, int Next_Y){
+                if (Next_X < 0 || Next_Y < 0 || Next_X >= Width || Next_Y >= Width)
+                    return;
+
+                uint32_t Next = (uint32_t)((size_t)Next_Y * Width + Next_X);
+
+                if (Visited[Next / 64] & (1ull << (Next % 64)))
+                    return;
+
+                Visited[Next / 64] |= 1ull << (Next % 64);
+                Queue.push_back(Next);
+
+                Weights[Next].Intensity += Intensity;
+            };
+
+            Reach(Cell_X - 1, Cell_Y);
+            Reach(Cell_X + 1, Cell_Y);
+            Reach(Cell_X, Cell_Y - 1);
+            Reach(Cell_X, Cell_Y + 1);
+        }
+
+        Ring_Begin = Ring_End;
+        Ring_End = Queue.size();
+    }
+
+    // Only the reached cells were marked, so only they need clearing for the next point.
+    for (auto Cell : Queue){
+        Visited[Cell / 64] &= ~(1ull << (Cell % 64));
+    }
+}
+
+// Two sided exponential filter down every column: row y becomes the sum of every row r times Diffuse^|y - r|.
+// The filter runs over whole rows at a time, and the columns do not depend on each other, so the inner loops vectorize.
+void Filter_Columns(float* Field, int Width, float Diffuse, vector<float>& Causal){
+    // Backward pass, every row gets the rows below it: B[y] = Field[y] + Diffuse * B[y + 1].
+    for (int y = Width - 2; y >= 0; y--){
+        float* Row = Field + (size_t)y * Width;
+        const float* Below = Row + Width;
+
+        for (int x = 0; x < Width; x++){
+            Row[x] += Diffuse * Below[x];
+        }
+    }
+
+    // Forward pass, the result is B[y] + Diffuse * F[y - 1], where F is the same running sum from above: F[y] = Field[y] + Diffuse * F[y - 1].
+    // The original row is gone, but it is B[y] - Diffuse * B[y + 1], so F[y] is the result - Diffuse * B[y + 1].
+    Causal.assign(Width, 0);
+
+    for (int y = 0; y < Width; y++){
+        float* Row = Field + (size_t)y * Width;
+
+        if (y + 1 == Width){
+            for (int x = 0; x < Width; x++){
+                Row[x] += Diffuse * Causal[x];
+            }
+
+            break;
+        }
+
+        const float* Below = Row + Width;
 
-        Weights[s.second * Speaks->Width + s.first].Intensity += Weights[y * Speaks->Width + x].Intensity * Diffuse;
+        for (int x = 0; x < Width; x++){
+            float Result = Row[x] + Diffuse * Causal[x];
 
-        //Cascade
-        Diffuse_Around_Point_Of_Interest(s.first, s.second, x, y);
+            Causal[x] = Result - Diffuse * Below[x];
+            Row[x] = Result;
+        }
     }
+}
 
+// Transposes in small tiles, so both the reads and the writes stay in cache.
+void Transpose(const float* From, float* To, int Width){
+    constexpr int TILE = 32;
+
+    for (int Tile_Y = 0; Tile_Y < Width; Tile_Y += TILE){
+        for (int Tile_X = 0; Tile_X < Width; Tile_X += TILE){
+            for (int y = Tile_Y; y < min(Tile_Y + TILE, Width); y++){
+                for (int x = Tile_X; x < min(Tile_X + TILE, Width); x++){
+                    To[(size_t)x * Width + y] = From[(size_t)y * Width + x];
+                }
+            }
+        }
+    }
+}
+
+void Convolve_Weights(vector<Weight>& Weights, int Width, float Diffuse, const vector<pair<int, int>>& Points){
+    vector<float> Field((size_t)Width * Width, 0);
+    vector<float> Transposed((size_t)Width * Width);
+    vector<float> Causal;
+
+    // The points give their weight to the field, and get it back with the rest of the filtered field.
+    for (auto& p : Points){
+        size_t Cell = (size_t)p.second * Width + p.first;
+        Weight& Point = Weights[Cell];
+
+        Field[Cell] = Point.Intensity;
+        Point.Intensity = 0;
+    }
+
+    // The rows are filtered as the columns of the transposed field, so both passes walk memory in order.
+    Filter_Columns(Field.data(), Width, Diffuse, Causal);
+    Transpose(Field.data(), Transposed.data(), Width);
+    Filter_Columns(Transposed.data(), Width, Diffuse, Causal);
+    Transpose(Transposed.data(), Field.data(), Width);
+
+    for (size_t i = 0; i < Field.size(); i++){
+        Weights[i].Intensity += Field[i];
+    }
 }
 
 // This function returns a random number between 0 and the count
-int Choose(int Count){
-    return max(rand(), 1) % Count;
+int Choose(Random& Generator, int Count){
+    return Generator.Below(Count);
+}
+
+Word* Teller::Next_Word(Word* Current){
+    uint32_t Next = Speaks->Next_Chain.Sample_Alias(Current->ID, Generator);
+
+    if (Next == UINT32_MAX)
+        return nullptr;
+
+    return Speaks->Markov_Buffer[Next];
+}
+
+string Teller::Generate_Thought(int Length){
+    string Result = "";
+
+    if (Speaks->Markov_Buffer.size() == 0)
+        return Result;
+
+    Word* Current = nullptr;
+
+    for (int i = 0; i < Length; i++){
+        if (Current)
+            Current = Next_Word(Current);
+
+        // Start from, or jump out of a dead end into, a random word.
+        if (!Current)
+            Current = Speaks->Markov_Buffer[Choose(Generator, Speaks->Markov_Buffer.size())];
+
+        if (i > 0)
+            Result += " ";
+
+        Result += Current->Data;
+    }
+
+    return Result;
+}
+
+bool Teller::Djikstra(vector<Word*>& Result, Word* Current, Word* End){
+    Result.clear();
+
+    if (!Paths.Bidirectional(Speaks->Next_Chain, Speaks->Previus_Chain, Current->ID, End->ID, Path))
+        return false;
+
+    for (auto ID : Path){
+        Result.push_back(Speaks->Markov_Buffer[ID]);
+    }
+
+    return true;
+}
+
+uint32_t Most_Used_Word(Array_View<int> Instances){
+    uint32_t Result = 0;
+
+    for (uint32_t ID = 1; ID < Instances.size(); ID++){
+        if (Instances[ID] > Instances[Result])
+            Result = ID;
+    }
+
+    return Result;
+}
+
+bool Teller::Landmark_A_Star(vector<Word*>& Result, Word* Current, Word* End){
+    Result.clear();
+
+    Speaks->Update_Landmarks(Paths);
+
+    const Landmarks& Guides = Speaks->Guides;
+    uint32_t End_ID = End->ID;
+
+    auto Heuristic = [&Guides, End_ID](uint32_t ID){
+        return Guides.Estimate(ID, End_ID);
+    };
+
+    if (!Paths.A_Star(Speaks->Next_Chain, Current->ID, End_ID, Heuristic, Path))
+        return false;
+
+    for (auto ID : Path){
+        Result.push_back(Speaks->Markov_Buffer[ID]);
+    }
+
+    return true;
+}
+
+// The cost of the path, summed over its edges.
+float Path_Cost(Transition_View Chain, const vector<uint32_t>& Path){
+    float Cost = 0;
+
+    for (size_t i = 1; i < Path.size(); i++){
+        Cost += Chain.Costs[Chain.Find(Path[i - 1], Path[i])];
+    }
+
+    return Cost;
+}
+
+void Teller::Print_Search_Expansions(int Pairs){
+    size_t Word_Count = Speaks->Markov_Buffer.size();
+
+    if (Word_Count == 0)
+        return;
+
+    Speaks->Update_Landmarks(Paths);
+
+    size_t Dijkstra_Expanded = 0;
+    size_t Bidirectional_Expanded = 0;
+    size_t A_Star_Expanded = 0;
+    int Connected = 0;
+    int Worse = 0;
+
+    vector<Word*> Words;
+
+    for (int i = 0; i < Pairs; i++){
+        Word* Start = Speaks->Markov_Buffer[Choose(Generator, Word_Count)];
+        Word* End = Speaks->Markov_Buffer[Choose(Generator, Word_Count)];
+
+        bool Found = Paths.Dijkstra(Speaks->Next_Chain, Start->ID, End->ID, Path);
+        Dijkstra_Expanded += Paths.Expanded;
+        float Cost = Path_Cost(Speaks->Next_Chain, Path);
+
+        Djikstra(Words, Start, End);
+        Bidirectional_Expanded += Paths.Expanded;
+
+        Landmark_A_Star(Words, Start, End);
+        A_Star_Expanded += Paths.Expanded;
+
+        if (!Found)
+            continue;
+
+        Connected++;
+
+        // Float sums in a different order can differ in the last bits.
+        if (Path_Cost(Speaks->Next_Chain, Path) > Cost * 1.0001f + 1e-4f)
+            Worse++;
+    }
+
+    cout << "Searched " << Pairs << " pairs, " << Connected << " were connected." << endl;
+    cout << "Dijkstra settled: " << Dijkstra_Expanded << endl;
+    cout << "Bidirectional Djikstra settled: " << Bidirectional_Expanded << endl;
+    cout << "Landmark A* settled: " << A_Star_Expanded << " with " << Speaks->Guides.Words.size() << " landmarks" << endl;
+    cout << "Landmark A* paths that cost more: " << Worse << endl;
 }
 
 void Teller::Print_Weights(string file_name){
@@ -6,49 +6,168 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <functional>
+#include <limits>
+#include <cmath>
+
+#include "Arena.h"
+#include "Hypercube_Layout.h"
+#include "Landmarks.h"
+#include "Path_Finder.h"
+#include "Random.h"
+#include "Sphere_Layout.h"
+#include "Vocabulary.h"
+#include "Transition_Matrix.h"
 
 using namespace std;
 
+class Vector2{
+public:
+    int X = 0;
+    int Y = 0;
+
+    Vector2(){}
+    Vector2(int X, int Y) : X(X), Y(Y) {}
+
+    std::size_t operator()() const {
+        return X * INT8_MAX + Y;
+    }
+};
+
 // A Language is a compilation of sentences specific to that language.
 class Language{
 public:
     string Language_Name = "";
 
     //This buffer contains the raw data that just got scooped from the given text file. 
+    // Files are streamed through Feed, so this is only filled by hand for Concat_Raw_Buffer().
     string Raw_Buffer = "";
 
-    // The raw buffer of words.
-    vector<class Word> Cut_Buffer;
+    // Every unique word is stored once in here, the rest of the language refers to words by their id.
+    Vocabulary Dictionary;
+
+    // The raw buffer of words, as Dictionary ids.
+    vector<uint32_t> Cut_Buffer;
+
+    // Owns the Markov words, they are packed together and all freed with the language.
+    Arena<class Word> Markov_Words;
+
+    // The Markov chain buffer, indexed by the Dictionary id.
+    vector<class Word*> Markov_Buffer;
+
+    // The attributes of the words, indexed by the Dictionary id.
+    // Each attribute is a column of its own, so a pass over one of them reads nothing else.
+    vector<Vector2> Positions;
+    vector<int> Instances;
+    vector<float> Importance;   // 0 to 1
+    vector<int> Complexity;     // How many words usually takes to describe this word.
+
+    // How many times each word was followed by another, kept as is so more text can be added later.
+    Edge_Counter Transitions;
 
-    // The Markov chain buffer, but made in map for improved performance.
-    unordered_map<string, class Word*> Fast_Markov;
+    // The Markov chain links built from the Transitions, by word id.
+    // Next_Chain lists the words that come after a word, Previus_Chain the words that come before it.
+    Transition_Matrix Next_Chain;
+    Transition_Matrix Previus_Chain;
+
+    // Bumped every time the chains are rebuilt or loaded, so what is derived from them knows to be made again.
+    uint32_t Chain_Generation = 0;
+
+    // The lower bounds the Landmark A* of the Teller heads towards its End by, see Landmarks.
+    // Made from the chains by Update_Landmarks, and kept for the Chain_Generation they were made for.
+    Landmarks Guides;
+    uint32_t Guides_Generation = UINT32_MAX;
+    // How many landmarks to pick, each one costs two floats per word and two searches over the whole chain to build.
+    uint32_t Landmark_Count = 16;
 
     // Width and height dimensions. X^2
     int Width = 0;
 
+    // Inverted index of the 2D map, word id to the cells where it is.
+    // The cells of a word are [Cell_Offsets[ID], Cell_Offsets[ID + 1]) in Cells, as y * Width + x in increasing order.
+    vector<uint32_t> Cell_Offsets;
+    vector<uint32_t> Cells;
+
+    // When false, streamed words only go into the Markov chain and the Cut_Buffer stays empty.
+    // This keeps the memory bounded by the vocabulary, but there will be no 2D map for the Teller.
+    bool Keep_Cut_Buffer = true;
+
+    // Streaming state carried between the Feed calls.
+    // The word that was cut in half by the end of the last chunk.
+    string Partial_Word = "";
+    // The last word that was added to the Markov chain.
+    class Word* Previus_Word = nullptr;
+
+    // Empty language, that is filled with Feed and Finalize.
+    Language(){}
+
     //Loads the file contenct to the cut buffer.
     // And applies the markov chain to it.
+    // The file is memory mapped and tokenized in place when possible.
     Language(string File_Name);
 
-    // This function cuts the buffer into words divided with whitespace.
+    // This function cuts the buffer into words divided with whitespace and delimiters.
     void Concat_Raw_Buffer();
+    // Same as above, but for any buffer, like a memory mapped file.
+    // Line endings count as whitespace.
+    // Big buffers are split into regions that are tokenized on all the hardware threads.
+    void Concat_Raw_Buffer(string_view Buffer);
+
+    // Tokenizes the chunk and adds the words straight into the Markov chain.
+    // Words cut by the chunk boundary are continued on the next Feed.
+    void Feed(string_view Chunk);
+
+    // Ends the stream, places the Cut_Buffer into 2D and finalizes the chain.
+    void Finalize();
 
+    // Builds the Markov chain from the whole Cut_Buffer at once, on all the hardware threads.
     void Apply_Markov_To_Buffer();
 
+    // Chains the token after the previusly added word, and returns the token id.
+    uint32_t Append_To_Markov(string_view Token);
+    uint32_t Append_To_Markov(uint32_t ID);
+
+    // Returns the Markov word for the id, making it and its attributes if it does not exist yet.
+    class Word* Get_Markov_Word(uint32_t ID);
+
+    // Gives every word in the Cut_Buffer its 2D position, and indexes the cells of every word.
+    void Layout_Cut_Buffer();
+
+    // Fills the Cell_Offsets and Cells from the 2D map, with a counting sort of the cells by their word.
+    void Index_Cells();
+
+    // Builds the Next_Chain and Previus_Chain from the Transitions, with their probabilities.
     void Finalize_Instance_Countters();
 
+    // Picks the Guides again if the chains have changed since they were last picked.
+    // The Paths are used for the searches over the chains.
+    void Update_Landmarks(Path_Finder& Paths);
+
     void Output(string File_Name);
 
+    // Writes the words, their attributes, the Cut_Buffer, both chains and the Guides into a binary snapshot, see Snapshot.h.
+    // The Guides are picked first, if the chains have changed since they last were.
+    // Returns false if the file could not be written.
+    bool Save(string File_Name);
+
+    // Fills an empty language from a snapshot made by Save.
+    // The snapshot is memory mapped and its arrays are copied over as is, nothing is tokenized or counted again.
+    // The Transitions are not part of the snapshot, they are counted back from the Next_Chain so more text can still be fed after the load.
+    bool Load(string File_Name);
+
 
 
     // Utils
     //-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_
     // Given cut buffers word returns markov chain index.
     class Word* Find(string w, int Start);
-    // Given cut buffers coordinates returns markov chain index.
+    // Given cut buffers coordinates returns markov chain word.
     class Word* Find(int x, int y);
+    // Returns the markov chain word, or nullptr if the language does not have it.
+    // The word is looked up in the Dictionary, whose ids index the Markov_Buffer.
+    class Word* Find(string_view w);
 
 };
 
@@ -61,57 +180,140 @@ public:
     Weight(float Intensity) : Intensity(Intensity) {};
 };
 
-class Vector2{
+// Returns the word ids ordered by their Instances, the most instances first and ties in id order.
+// The counts are bounded integers, so this is an LSD radix sort one byte at a time, and only as many bytes as the biggest count has.
+// Each pass counts the digits of its shard on its own thread, and the shards then scatter into their precomputed ranges.
+vector<uint32_t> Order_By_Instances(const vector<int>& Instances);
+
+// The word with the most instances, where the Landmarks start from.
+// 0 for a language without words.
+uint32_t Most_Used_Word(Array_View<int> Instances);
+
+// Weight map helpers, shared by the Teller and the Language_View.
+// The maps are Width x Width cells, in the same order as the Cut_Buffer.
+//-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_
+// How the weights are diffused into the surrounding cells.
+// Both add Intensity * Diffuse^d from every weighted cell into the cells d steps away, but they do not give the same map.
+// The SPREAD cuts each point off where its weight fades under the Threshold, the CONVOLUTION never does.
+// One point loses little to the cut off, but where weighted cells lie close together the cut off tails add up, so the modes drift further apart.
+// In both modes the points add up, so cells near many points can go past -1 to 1.
+enum class Diffusion_Mode{
+    // Weight_Diffuser from every weighted cell, costs as much as the cells the weights reach.
+    SPREAD,
+    // Convolve_Weights over the whole map at once, costs the same no matter how many cells are weighted.
+    CONVOLUTION,
+};
+
+// Sets the weight of every cell whose word has one, and diffuses it into the surrounding cells.
+// The cells of the words are found through the Cell_Offsets and Cells index of the language, so the rest of the map is never looked at.
+// Weights that are not Width * Width cells are reset to zero first.
+void Apply_Weights(vector<Weight>& Weights, int Width, float Diffuse, Diffusion_Mode Mode, Array_View<uint32_t> Cell_Offsets, Array_View<uint32_t> Cells, const vector<pair<Weight, uint32_t>>& Weighted_IDs);
+
+// Makes a slow burning gradient around points on the weight map.
+// Each step away from the point, up, down, left or right, multiplies its weight by Diffuse once more.
+// The spreading goes one ring of cells at a time and stops at the radius where the weight fades under the Threshold.
+// Every cell in that radius is visited once, so a point costs as much as the cells it reaches and nothing more.
+class Weight_Diffuser{
 public:
-    int X = 0;
-    int Y = 0;
+    int Width = 0;
 
-    Vector2(){}
-    Vector2(int X, int Y) : X(X), Y(Y) {}
+    // One bit per cell, set for the cells the current point has reached.
+    vector<uint64_t> Visited;
 
-    std::size_t operator()() const {
-        return X * INT8_MAX + Y;
-    }
+    // The cells the current point has reached, ring by ring.
+    vector<uint32_t> Queue;
+
+    Weight_Diffuser(int Width) : Width(Width), Visited(((size_t)Width * Width + 63) / 64, 0) {}
+
+    // Adds the Intensity, times Diffuse^d, into every cell d steps away from the cell at x, y.
+    // The cell itself is left as it is.
+    void Spread(vector<Weight>& Weights, float Diffuse, int x, int y, float Intensity);
 };
 
+// The gradient of the Weight_Diffuser for all the points at once, but without its Threshold cut off, see Diffusion_Mode.
+// Diffuse^(|dx| + |dy|) is Diffuse^|dx| times Diffuse^|dy|, so the spread is a separable filter.
+// One pass filters the columns and another the rows, each pass is two sided exponential running sums.
+// Points are the cells whose weight is spread, the weights of the other cells stay as they are.
+void Convolve_Weights(vector<Weight>& Weights, int Width, float Diffuse, const vector<pair<int, int>>& Points);
+
 // A word contains the word id and the language id it references to.
 // This enables main language speak with some words replaced with some other language.
 // This phenomenon sometimes occurs when a entity knows more than one language.
+// The attributes of the word are in the columns of its language, by the ID.
 class Word{
 public:
-    string Data = "";
+    // Id of this word in the Dictionary of its language.
+    uint32_t ID = 0;
 
-    Vector2 Position;
+    // Points into the Dictionary of its language.
+    string_view Data = "";
 
-    vector<pair<int, Word*>> Next_Chain;
-    vector<pair<int, Word*>> Previus_Chain;
+    Word(uint32_t ID, string_view Data) : ID(ID), Data(Data) {};
+};
 
-    int Instances = 0;
-    float Importance = 1;   // 0 to 1
-    int Complexity = 0;     // How many words usually takes to describe this word.
+// The square ring of cells at Distance steps from the Center, counting diagonal steps as one.
+// The cells are made on the fly, any cell of the ring is found in O(1) without the rings inside it.
+// Distance 0 is just the center, and every ring after it has 8 * Distance cells.
+// The cells go clockwise from the top left corner, and some of them may be outside of the map.
+class Square_Ring{
+public:
+    Vector2 Center;
+    int Distance = 0;
 
-    Word(string Data) : Data(Data) {};
+    Square_Ring(Vector2 Center, int Distance) : Center(Center), Distance(Distance) {}
 
-    pair<int, Word*>* Get_Next(string word){
-        for (auto& iter : Next_Chain){
-            if (iter.second->Data == word)
-                return &iter;
-        }
+    int size() const{
+        return Distance == 0 ? 1 : 8 * Distance;
+    }
 
-        return nullptr;
+    Vector2 operator[](int Index) const{
+        if (Distance == 0)
+            return Center;
+
+        // Each side has 2 * Distance cells, and ends where the next side begins.
+        int Side = 2 * Distance;
+        int Left = Center.X - Distance;
+        int Top = Center.Y - Distance;
+        int Right = Center.X + Distance;
+        int Bottom = Center.Y + Distance;
+
+        if (Index < Side)
+            return {Left + Index, Top};
+
+        if (Index < 2 * Side)
+            return {Right, Top + Index - Side};
+
+        if (Index < 3 * Side)
+            return {Right - (Index - 2 * Side), Bottom};
+
+        return {Left, Bottom - (Index - 3 * Side)};
     }
 
-    pair<int, Word*>* Get_Prev(string word){
-        for (auto& iter : Previus_Chain){
-            if (iter.second->Data == word)
-                return &iter;
+    class Iterator{
+    public:
+        const Square_Ring* Ring;
+        int Index;
+
+        Vector2 operator*() const{
+            return (*Ring)[Index];
         }
 
-        return nullptr;
+        Iterator& operator++(){
+            Index++;
+            return *this;
+        }
+
+        bool operator!=(const Iterator& Other) const{
+            return Index != Other.Index;
+        }
+    };
+
+    Iterator begin() const{
+        return {this, 0};
     }
 
-    Word(char Data) {
-        this->Data = string(1, Data);
+    Iterator end() const{
+        return {this, size()};
     }
 };
 
@@ -133,17 +335,67 @@ public:
     Transformation(Vector2 Origin, Vector2 Target) : Origin(Origin), Target(Target) {}
 };
 
-class Transforms{
+// All the transforms of the gradient map, one flat array per gradient kind.
+// Every cell is the Target of its transforms, so only the Origins are stored and the Target is rebuilt from the cell.
+// Which cells of a kind got a transform is kept in a bitset next to it, so a missing transform costs one bit.
+// The arrays of a kind are only allocated once a transform of that kind is added.
+class Transform_Map{
 public:
-    // <ID, Transform>
-    unordered_map<int, Transformation> Transforms;
+    static constexpr int KINDS = (int)IDS::CIRCULAR_DALMIAN_GRADIENT + 1;
+
+    int Width = 0;
+
+    vector<Vector2> Origins[KINDS];
+    vector<uint64_t> Present[KINDS];
+
+    // Drops all the transforms and sizes the map to Width * Width cells.
+    void Resize(int width){
+        Width = width;
+
+        for (int i = 0; i < KINDS; i++){
+            Origins[i].clear();
+            Present[i].clear();
+        }
+    }
 
+    size_t Size() const{
+        return (size_t)Width * Width;
+    }
+
+    // Drops the transforms of one kind, the others stay.
+    void Clear(IDS ID){
+        Origins[(int)ID].clear();
+        Present[(int)ID].clear();
+    }
+
+    // Saves the transform into the cell of its Target, Targets outside of the map are ignored.
     void Add_Transform(IDS ID, Transformation transform){
-        Transforms[(int)ID] = transform;
+        Vector2 Target = transform.Target;
+
+        if (Target.X < 0 || Target.Y < 0 || Target.X >= Width || Target.Y >= Width)
+            return;
+
+        int Kind = (int)ID;
+        size_t Cell = (size_t)Target.Y * Width + Target.X;
+
+        if (Origins[Kind].empty()){
+            Origins[Kind].resize(Size());
+            Present[Kind].resize((Size() + 63) / 64);
+        }
+
+        Origins[Kind][Cell] = transform.Origin;
+        Present[Kind][Cell / 64] |= (uint64_t)1 << (Cell % 64);
+    }
+
+    bool Has_Transform(IDS ID, size_t Cell) const{
+        const vector<uint64_t>& Bits = Present[(int)ID];
+
+        return !Bits.empty() && (Bits[Cell / 64] >> (Cell % 64) & 1);
     }
 
-    Transformation* Get_Transform(IDS ID){
-        return &Transforms[(int)ID];
+    // Only valid when Has_Transform is.
+    Transformation Get_Transform(IDS ID, size_t Cell) const{
+        return {Origins[(int)ID][Cell], {(int)(Cell % Width), (int)(Cell / Width)}};
     }
 };
 
@@ -159,11 +411,32 @@ public:
     // 1 = no change, x < 1 weight will influense less area around it.
     float Diffuse = .5f;
 
+    // Many weighted words are faster to diffuse with the CONVOLUTION, few with the SPREAD.
+    // The two do not give the same weights, see Diffusion_Mode.
+    Diffusion_Mode Diffusion = Diffusion_Mode::SPREAD;
+
     //What language the entity speaks.
     Language* Speaks = nullptr;
+
+    // Used for all the random choices the entity makes.
+    Random Generator;
+
+    // Reused by every path search, so the searches do not allocate.
+    Path_Finder Paths;
+    // The word ids of the last found path, before they are turned into Words.
+    vector<uint32_t> Path;
+
     
     // List of all transforms performed into the singular index.
-    vector<Transforms> Gradient_Map;
+    Transform_Map Gradient_Map;
+
+    // The keyword corner layout made by Cubical_Dalmian_Gradient.
+    Hypercube_Layout Cube;
+
+    // The spherical layout made by Spherical_Dalmian_Gradient.
+    Sphere_Layout Sphere;
+    // How many points the sphere has, it gets four times the keywords instead when there are more of them.
+    uint32_t Sphere_Resolution = 4096;
 
     Teller(Language* lang);
 
@@ -182,18 +455,55 @@ public:
     // Uses more memory.
     // Goods:
     // All points are at the same distance from each other.
+    // The cube is kept in the Cube, and its cells are flattened onto the gradient map in Morton order.
     void Cubical_Dalmian_Gradient();
     // same as the above but uses low resolution pointed spherical space.
     // Down sides:
     // Not all points have same distance from each other.
     // Goods:
     // Uses less memory when using just circle or spherical array.
+    // The sphere is kept in the Sphere, and its points are unwrapped onto the gradient map by latitude and then longitude.
     void Spherical_Dalmian_Gradient();
     void Circular_Dalmian_Gradient();
 
+    // Hands the cells of the map out to the Ordered_Words, every word gets as many cells as it has on the Cut_Buffer.
+    // For_Each_Cell(Visit) has to call Visit(Vector2) once for every cell of the map, in the order the words fill them.
+    // The map has exactly as many cells as the words have together, so every word gets its cells.
+    // Only the transforms of the ID are replaced, unless the map has changed size and is made again.
+    template<typename F>
+    void Fill_Gradient(IDS ID, const vector<uint32_t>& Ordered_Words, F For_Each_Cell){
+        if (Gradient_Map.Width != Speaks->Width)
+            Gradient_Map.Resize(Speaks->Width);
+        else
+            Gradient_Map.Clear(ID);
+
+        const vector<uint32_t>& Cell_Offsets = Speaks->Cell_Offsets;
+
+        size_t Order_Index = 0;
+        uint32_t Cells_Left = 0;
+        Vector2 Origin;
+
+        For_Each_Cell([&](Vector2 Cell){
+            // Move to the next word that has cells left.
+            while (Cells_Left == 0){
+                uint32_t Word_ID = Ordered_Words[Order_Index++];
+
+                Cells_Left = Cell_Offsets[Word_ID + 1] - Cell_Offsets[Word_ID];
+                Origin = Speaks->Positions[Word_ID];
+            }
+
+            Cells_Left--;
+
+            // Save the transformation suggestions.
+            Gradient_Map.Add_Transform(ID, {Origin, Cell});
+        });
+    }
+
     void Calculate_Importance_Scaling();
     // All words that have the Importance Scaler above 0.5 pass as keywords.
-    vector<Word*> Get_Keywords();
+    // Returns their ids.
+    vector<uint32_t> Get_Keywords();
+    // All the cells from the origin out to Distance_From_Center, ring by ring, see Square_Ring.
     vector<Vector2> Get_Surrounding(Vector2 origin, int Distance_From_Center);
 
 
@@ -201,8 +511,8 @@ public:
     //-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_
     void Init_Weight(vector<pair<Weight,string>> weights = {});
     vector<pair<int, int>> Get_Surrounding(int x, int y);
-    // Makes a slow burning gradient around the points given.
-    void Diffuse_Around_Point_Of_Interest(int x, int y, int parent_x, int parent_y);
+    // Makes a slow burning gradient around the point given, see Weight_Diffuser.
+    void Diffuse_Around_Point_Of_Interest(int x, int y);
     void Print_Weights(string file_name);   
 
     // Circular tools 
@@ -211,8 +521,22 @@ public:
     float Get_Radians_From_Circle_Perimeter(Vector2 perimeter_position, int Radius);
     float Get_Symmetrical_Spacing_On_Circle_Perimeter(int Point_Count);
 
-    // 
+    // Generation
+    //-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_
+    // Picks the next word by the Markov chain probabilities in O(1), or nullptr if nothing ever followed the current word.
+    Word* Next_Word(Word* Current);
+    // Random walk of Length words through the Markov chain.
+    string Generate_Thought(int Length);
+
+    // Finds the most probable chain of words from Current to End, both included.
+    // Returns false if End cannot be reached from Current.
     bool Djikstra(vector<Word*>& Result, Word* Current, Word* End);
+    // Same as above, but A* that heads towards End by the Guides of the language, which are updated first.
+    // The Guides never overestimate, so the path is the same most probable one.
+    bool Landmark_A_Star(vector<Word*>& Result, Word* Current, Word* End);
+    // Searches between Pairs random words with the plain Dijkstra, the bidirectional Djikstra and the Landmark_A_Star.
+    // Prints how many words each settled in total, and how many of the paths the A* found cost more than the ones of the plain Dijkstra, which should be none.
+    void Print_Search_Expansions(int Pairs);
 };
 
 
@@ -0,0 +1,164 @@
+#ifndef _FLAT_MAP_H_
+#define _FLAT_MAP_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// 64 bit hash for words, reads 8 bytes at a time.
+// Never returns 0, since the Flat_Map uses that for empty slots.
+// Only the one hash of 0 is moved, the low bits pick the home slot, so they are all kept as they are.
+inline uint64_t Hash_Word(string_view Word){
+    const char* Data = Word.data();
+    size_t Left = Word.size();
+
+    uint64_t Hash = 0x9E3779B97F4A7C15ull ^ Left;
+
+    while (Left >= 8){
+        uint64_t Chunk;
+        memcpy(&Chunk, Data, 8);
+
+        Hash = (Hash ^ Chunk) * 0xff51afd7ed558ccdull;
+        Hash ^= Hash >> 32;
+
+        Data += 8;
+        Left -= 8;
+    }
+
+    if (Left > 0){
+        uint64_t Chunk = 0;
+        memcpy(&Chunk, Data, Left);
+
+        Hash = (Hash ^ Chunk) * 0xc4ceb9fe1a85ec53ull;
+        Hash ^= Hash >> 29;
+    }
+
+    Hash *= 0xff51afd7ed558ccdull;
+    Hash ^= Hash >> 32;
+
+    return Hash ? Hash : 1;
+}
+
+// Open addressing hash table from words to values, with Robin Hood probing.
+// All the slots are in one array, and each slot keeps the full hash of its word.
+// So a probe only compares the words when the hashes match, and growing never hashes a word again.
+// The keys are views, the words themselves have to outlive the map.
+template<typename T>
+class Flat_Map{
+public:
+    struct Slot{
+        // 0 when the slot is empty.
+        uint64_t Hash = 0;
+        string_view Key;
+        T Value;
+    };
+
+    vector<Slot> Slots;
+    size_t Size = 0;
+
+    // Returns the value of the word, or nullptr.
+    // Unlike the operator[] of unordered_map this never inserts anything.
+    T* Find(string_view Key){
+        return Find(Key, Hash_Word(Key));
+    }
+
+    T* Find(string_view Key, uint64_t Hash){
+        if (Slots.size() == 0)
+            return nullptr;
+
+        size_t Mask = Slots.size() - 1;
+
+        for (size_t i = Hash & Mask, Distance = 0; ; i = (i + 1) & Mask, Distance++){
+            Slot& Current = Slots[i];
+
+            // A richer slot than us means our word would have been placed before it.
+            if (Current.Hash == 0 || Probe_Distance(Current.Hash, i) < Distance)
+                return nullptr;
+
+            if (Current.Hash == Hash && Current.Key == Key)
+                return &Current.Value;
+        }
+    }
+
+    // Adds the word if it is not there yet, and returns its value either way.
+    T& Insert(string_view Key, uint64_t Hash, T Value){
+        if (T* Existing = Find(Key, Hash))
+            return *Existing;
+
+        // Keep at most 7/8 of the slots in use, so the probe chains stay short.
+        if ((Size + 1) * 8 > Slots.size() * 7)
+            Grow();
+
+        Size++;
+
+        return *Place({Hash, Key, move(Value)});
+    }
+
+    T& Insert(string_view Key, T Value){
+        return Insert(Key, Hash_Word(Key), move(Value));
+    }
+
+    size_t Probe_Distance(uint64_t Hash, size_t Index){
+        return (Index - (Hash & (Slots.size() - 1))) & (Slots.size() - 1);
+    }
+
+    // Robin Hood placement, the incoming slot takes the place of any slot that is closer to its home than the incoming one.
+    // Returns where the original value ended up.
+    T* Place(Slot Incoming){
+        size_t Mask = Slots.size() - 1;
+        T* Result = nullptr;
+
+        for (size_t i = Incoming.Hash & Mask, Distance = 0; ; i = (i + 1) & Mask, Distance++){
+            Slot& Current = Slots[i];
+
+            if (Current.Hash == 0){
+                Current = move(Incoming);
+                return Result ? Result : &Current.Value;
+            }
+
+            size_t Current_Distance = Probe_Distance(Current.Hash, i);
+
+            if (Current_Distance < Distance){
+                swap(Current, Incoming);
+                Distance = Current_Distance;
+
+                if (!Result)
+                    Result = &Current.Value;
+            }
+        }
+    }
+
+    void Grow(){
+        Rehash(Slots.size() == 0 ? 64 : Slots.size() * 2);
+    }
+
+    // Makes room for Count words up front, so inserting them never grows the table.
+    void Reserve(size_t Count){
+        size_t Needed = 64;
+
+        while (Count * 8 > Needed * 7)
+            Needed *= 2;
+
+        if (Needed > Slots.size())
+            Rehash(Needed);
+    }
+
+    // Moves every slot into a table of Slot_Count slots, which has to be a power of two.
+    void Rehash(size_t Slot_Count){
+        vector<Slot> Old = move(Slots);
+
+        Slots.clear();
+        Slots.resize(Slot_Count);
+
+        for (auto& s : Old){
+            if (s.Hash != 0)
+                Place(move(s));
+        }
+    }
+};
+
+#endif
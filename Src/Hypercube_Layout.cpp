@@ -0,0 +1,123 @@
+#include "Hypercube_Layout.h"
+
+#include <algorithm>
+
+#include "Keyword_Affinity.h"
+#include "Parallel.h"
+
+using namespace std;
+
+void Hypercube_Layout::Build(Transition_View Next, Transition_View Previus, const vector<uint32_t>& keywords, size_t Word_Count){
+    Keywords = keywords;
+
+    // Enough dimensions for every keyword to get a corner, but always at least one axis.
+    Dimensions = 1;
+    while (Dimensions < 64 && ((uint64_t)1 << Dimensions) < Keywords.size()){
+        Dimensions++;
+    }
+
+    Bits = min(16, 64 / Dimensions);
+    uint32_t Max = (1u << Bits) - 1;
+
+    vector<int32_t> Keyword_Index = Index_Keywords(Keywords, Word_Count);
+
+    Codes.resize(Word_Count);
+
+    Parallel_For(Word_Count, [&](unsigned, size_t Begin, size_t End){
+        vector<float> Sums(Dimensions);
+        vector<uint32_t> Coordinates(Dimensions);
+
+        for (size_t ID = Begin; ID < End; ID++){
+            int32_t Own = Keyword_Index[ID];
+
+            if (Own >= 0){
+                for (int d = 0; d < Dimensions; d++){
+                    Coordinates[d] = ((uint64_t)Own >> d & 1) ? Max : 0;
+                }
+
+                Codes[ID] = Encode(Coordinates.data());
+                continue;
+            }
+
+            fill(Sums.begin(), Sums.end(), 0.0f);
+            float Total = 0;
+
+            // Every transition to or from a keyword pulls the word towards the corner of that keyword.
+            For_Each_Keyword_Link(Next, Previus, Keyword_Index, ID, [&](int32_t k, float Count){
+                Total += Count;
+
+                for (int d = 0; d < Dimensions; d++){
+                    if ((uint64_t)k >> d & 1)
+                        Sums[d] += Count;
+                }
+            });
+
+            for (int d = 0; d < Dimensions; d++){
+                float Mean = Total > 0 ? Sums[d] / Total : 0.5f;
+
+                Coordinates[d] = (uint32_t)(Mean * Max + 0.5f);
+            }
+
+            Codes[ID] = Encode(Coordinates.data());
+        }
+    });
+
+    // Sort the words by their cell, so the words of a cell are next to each other.
+    vector<pair<uint64_t, uint32_t>> Sorted(Word_Count);
+
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        Sorted[ID] = {Codes[ID], (uint32_t)ID};
+    }
+
+    sort(Sorted.begin(), Sorted.end());
+
+    Words.resize(Word_Count);
+    Cell_Codes.clear();
+    Cell_Offsets.clear();
+
+    for (size_t i = 0; i < Word_Count; i++){
+        Words[i] = Sorted[i].second;
+
+        if (i == 0 || Sorted[i].first != Sorted[i - 1].first){
+            Cell_Codes.push_back(Sorted[i].first);
+            Cell_Offsets.push_back((uint32_t)i);
+        }
+    }
+
+    Cell_Offsets.push_back((uint32_t)Word_Count);
+}
+
+uint64_t Hypercube_Layout::Encode(const uint32_t* Coordinates) const{
+    uint64_t Code = 0;
+
+    for (int b = 0; b < Bits; b++){
+        for (int d = 0; d < Dimensions; d++){
+            Code |= (uint64_t)(Coordinates[d] >> b & 1) << (b * Dimensions + d);
+        }
+    }
+
+    return Code;
+}
+
+void Hypercube_Layout::Decode(uint64_t Code, uint32_t* Coordinates) const{
+    for (int d = 0; d < Dimensions; d++){
+        Coordinates[d] = 0;
+    }
+
+    for (int b = 0; b < Bits; b++){
+        for (int d = 0; d < Dimensions; d++){
+            Coordinates[d] |= (uint32_t)(Code >> (b * Dimensions + d) & 1) << b;
+        }
+    }
+}
+
+Array_View<uint32_t> Hypercube_Layout::Find(uint64_t Code) const{
+    auto Cell = lower_bound(Cell_Codes.begin(), Cell_Codes.end(), Code);
+
+    if (Cell == Cell_Codes.end() || *Cell != Code)
+        return {};
+
+    size_t Index = Cell - Cell_Codes.begin();
+
+    return {Words.data() + Cell_Offsets[Index], Cell_Offsets[Index + 1] - Cell_Offsets[Index]};
+}
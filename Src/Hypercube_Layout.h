@@ -0,0 +1,49 @@
+#ifndef _HYPERCUBE_LAYOUT_H_
+#define _HYPERCUBE_LAYOUT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Array_View.h"
+#include "Transition_Matrix.h"
+
+using namespace std;
+
+// N dimensional layout of the words, where every keyword owns its own corner of a hypercube.
+// With K keywords the cube has ceil(log2 K) dimensions, and keyword k sits at the far end of axis d when bit d of k is set.
+// Every other word is placed at the mean of the corners of the keywords it has transitions to or from, weighted by their counts.
+// Words with no keyword next to them end up in the middle of the cube.
+// The coordinates of a cell are interleaved bit by bit into one 64 bit Morton code, so cells close in the cube mostly have close codes.
+// Only the cells that have words in them are stored, sorted by their code, so the memory stays linear to the words no matter the dimensions.
+class Hypercube_Layout{
+public:
+    int Dimensions = 0;
+    // Each axis has 1 << Bits cells, Dimensions * Bits always fits into the 64 bit code.
+    int Bits = 0;
+
+    // Keyword index to the word id.
+    vector<uint32_t> Keywords;
+
+    // Word id to the Morton code of its cell.
+    vector<uint64_t> Codes;
+
+    // The occupied cells in Morton order, and where their words start in the Words, with one extra offset for the end of the last cell.
+    vector<uint64_t> Cell_Codes;
+    vector<uint32_t> Cell_Offsets;
+    // All the word ids in Morton order, ties in id order.
+    vector<uint32_t> Words;
+
+    // Lays out Word_Count words, the keyword corners are given in the order of the Keywords.
+    // Either chain can be left empty.
+    void Build(Transition_View Next, Transition_View Previus, const vector<uint32_t>& Keywords, size_t Word_Count);
+
+    // Coordinates has Dimensions values, each below 1 << Bits.
+    uint64_t Encode(const uint32_t* Coordinates) const;
+    void Decode(uint64_t Code, uint32_t* Coordinates) const;
+
+    // The words in the cell of the Morton code, empty if the cell has none.
+    // Binary searches the occupied cells, so this is O(log cells).
+    Array_View<uint32_t> Find(uint64_t Code) const;
+};
+
+#endif
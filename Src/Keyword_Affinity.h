@@ -0,0 +1,41 @@
+#ifndef _KEYWORD_AFFINITY_H_
+#define _KEYWORD_AFFINITY_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Transition_Matrix.h"
+
+using namespace std;
+
+// Shared by the layouts that place every word by the keywords it is chained to.
+
+// Word id to its index in the Keywords, -1 for the words that are not keywords.
+inline vector<int32_t> Index_Keywords(const vector<uint32_t>& Keywords, size_t Word_Count){
+    vector<int32_t> Keyword_Index(Word_Count, -1);
+
+    for (size_t k = 0; k < Keywords.size(); k++){
+        Keyword_Index[Keywords[k]] = (int32_t)k;
+    }
+
+    return Keyword_Index;
+}
+
+// Calls Pull(k, Count) for every transition of the word to or from keyword k, with the count of that transition.
+// Either chain can be left empty.
+template<typename F>
+void For_Each_Keyword_Link(Transition_View Next, Transition_View Previus, const vector<int32_t>& Keyword_Index, size_t ID, F Pull){
+    for (Transition_View Chain : {Next, Previus}){
+        if (Chain.Offsets.size() <= ID + 1)
+            continue;
+
+        for (uint32_t Edge = Chain.Offsets[ID]; Edge < Chain.Offsets[ID + 1]; Edge++){
+            int32_t k = Keyword_Index[Chain.Targets[Edge]];
+
+            if (k >= 0)
+                Pull(k, (float)Chain.Counts[Edge]);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "Landmarks.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+void Landmarks::Build(Transition_View Next, Transition_View Previus, uint32_t First, uint32_t Count, Path_Finder& Paths){
+    size_t Word_Count = Next.Offsets.size() > 0 ? Next.Offsets.size() - 1 : 0;
+
+    Words.clear();
+
+    if (Word_Count == 0 || Count == 0){
+        From.clear();
+        To.clear();
+        return;
+    }
+
+    Count = (uint32_t)min<size_t>(Count, Word_Count);
+
+    // The searches fill one landmark at a time, and are then interleaved by word.
+    vector<vector<float>> Landmark_From;
+    vector<vector<float>> Landmark_To;
+
+    // How far each word is there and back from the closest landmark so far, infinity until some landmark reaches it both ways.
+    vector<float> Closest(Word_Count, numeric_limits<float>::infinity());
+
+    // The picked words are left out of the next picks.
+    vector<bool> Picked(Word_Count, false);
+
+    uint32_t Landmark = First;
+
+    while (true){
+        Words.push_back(Landmark);
+        Picked[Landmark] = true;
+
+        Landmark_From.emplace_back();
+        Landmark_To.emplace_back();
+
+        Paths.Distances_From(Next, Landmark, Landmark_From.back());
+        Paths.Distances_To(Next, Previus, Landmark, Landmark_To.back());
+
+        if (Words.size() == Count)
+            break;
+
+        // The next landmark is the word furthest from all the picked ones, among the words they can reach and be reached from.
+        // Words outside of that would give bounds only for the few words around them.
+        float Furthest = -1;
+        uint32_t Next_Landmark = UINT32_MAX;
+
+        for (size_t ID = 0; ID < Word_Count; ID++){
+            float Round_Trip = Landmark_From.back()[ID] + Landmark_To.back()[ID];
+
+            Closest[ID] = min(Closest[ID], Round_Trip);
+
+            if (!Picked[ID] && !isinf(Closest[ID]) && Closest[ID] > Furthest){
+                Furthest = Closest[ID];
+                Next_Landmark = (uint32_t)ID;
+            }
+        }
+
+        if (Next_Landmark == UINT32_MAX)
+            break;
+
+        Landmark = Next_Landmark;
+    }
+
+    size_t Picked_Count = Words.size();
+
+    From.resize(Word_Count * Picked_Count);
+    To.resize(Word_Count * Picked_Count);
+
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        for (size_t l = 0; l < Picked_Count; l++){
+            From[ID * Picked_Count + l] = Landmark_From[l][ID];
+            To[ID * Picked_Count + l] = Landmark_To[l][ID];
+        }
+    }
+}
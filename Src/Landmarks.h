@@ -0,0 +1,91 @@
+#ifndef _LANDMARKS_H_
+#define _LANDMARKS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Array_View.h"
+#include "Path_Finder.h"
+#include "Transition_Matrix.h"
+
+using namespace std;
+
+// Read only Landmarks over arrays owned by someone else, like a memory mapped snapshot.
+// See Landmarks for what the arrays hold.
+class Landmark_View{
+public:
+    Array_View<uint32_t> Words;
+    Array_View<float> From;
+    Array_View<float> To;
+
+    bool Empty() const{
+        return Words.size() == 0;
+    }
+
+    // Lower bound of the cost from the word to the End, infinity when the word cannot reach the End at all.
+    // Words the landmarks were not picked for get 0, which is always a lower bound.
+    float Estimate(uint32_t ID, uint32_t End) const{
+        size_t Count = Words.size();
+
+        if (Count == 0 || max(ID, End) >= From.size() / Count)
+            return 0;
+
+        const float* From_Word = From.begin() + ID * Count;
+        const float* From_End = From.begin() + End * Count;
+        const float* To_Word = To.begin() + ID * Count;
+        const float* To_End = To.begin() + End * Count;
+
+        float Best = 0;
+
+        // When neither word is connected to the landmark, the bound is infinity minus infinity.
+        // That is NaN, which is never bigger, so the landmark just doesn't count.
+        for (size_t l = 0; l < Count; l++){
+            float Forward = From_End[l] - From_Word[l];
+            float Backward = To_Word[l] - To_End[l];
+
+            if (Forward > Best)
+                Best = Forward;
+
+            if (Backward > Best)
+                Best = Backward;
+        }
+
+        return Best;
+    }
+};
+
+// Lower bounds of the path cost between any two words, from the path costs to and from a few landmark words.
+// By the triangle inequality a path from a word to the End costs at least
+// From(L, End) - From(L, word) and To(word, L) - To(End, L) for every landmark L, so the biggest of those never overestimates.
+// The bounds come from the chain itself, so unlike a distance on a 2D map they stay useful when many edges cost nothing.
+class Landmarks{
+public:
+    // Landmark index to its word id.
+    vector<uint32_t> Words;
+
+    // The cost of the most probable path from each landmark to the word, and from the word to each landmark.
+    // Both are laid out by word, the values of word ID are [ID * Words.size(), (ID + 1) * Words.size()).
+    // Infinity when there is no path.
+    vector<float> From;
+    vector<float> To;
+
+    // Picks up to Count landmarks, starting from the First word.
+    // Every next landmark is the word the furthest away from the landmarks picked so far, there and back, so they end up on the rims of the chain.
+    // Each landmark costs one search forward through Next and one backwards through Previus, which needs its Mirror linked.
+    void Build(Transition_View Next, Transition_View Previus, uint32_t First, uint32_t Count, Path_Finder& Paths);
+
+    bool Empty() const{
+        return Words.size() == 0;
+    }
+
+    // The landmarks as a Landmark_View, which is what the searches read.
+    operator Landmark_View() const{
+        return {Words, From, To};
+    }
+
+    float Estimate(uint32_t ID, uint32_t End) const{
+        return Landmark_View(*this).Estimate(ID, End);
+    }
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "Language_View.h"
+
+#include <iostream>
+
+using namespace std;
+
+Language_View::Language_View(string File_Name) : File(File_Name, false){
+    if (!File.Is_Open()){
+        cout << "Error while opening file" << endl;
+        return;
+    }
+
+    const char* Data = File.Data;
+    const Snapshot_Header* Read_Header = Snapshot_Header::Read(Data, File.Size);
+
+    if (!Read_Header){
+        cout << "Not a snapshot of version " << SNAPSHOT_VERSION << ": " << File_Name << endl;
+        return;
+    }
+
+    auto Bind = [&](auto& View, Snapshot_Section Section){
+        using T = typename remove_reference_t<decltype(View)>::Type;
+        View = {Read_Header->Get<T>(Data, Section), Read_Header->Count<T>(Section)};
+    };
+
+    Bind(Word_Offsets, Snapshot_Section::WORD_OFFSETS);
+    Bind(Characters, Snapshot_Section::CHARACTERS);
+    Bind(Hashes, Snapshot_Section::WORD_HASHES);
+    Bind(Word_Table, Snapshot_Section::WORD_TABLE);
+    Bind(Positions, Snapshot_Section::POSITIONS);
+    Bind(Instances, Snapshot_Section::INSTANCES);
+    Bind(Importance, Snapshot_Section::IMPORTANCE);
+    Bind(Complexity, Snapshot_Section::COMPLEXITY);
+    Bind(Cut_Buffer, Snapshot_Section::CUT_BUFFER);
+    Bind(Cell_Offsets, Snapshot_Section::CELL_OFFSETS);
+    Bind(Cells, Snapshot_Section::CELLS);
+
+    auto Matrix = [&](Transition_View& Chain, Snapshot_Section First){
+        Bind(Chain.Offsets, First + 0);
+        Bind(Chain.Targets, First + 1);
+        Bind(Chain.Counts, First + 2);
+        Bind(Chain.Probabilities, First + 3);
+        Bind(Chain.Cumulative, First + 4);
+        Bind(Chain.Costs, First + 5);
+        Bind(Chain.Mirror, First + 6);
+        Bind(Chain.Alias_Probability, First + 7);
+        Bind(Chain.Alias, First + 8);
+    };
+
+    Matrix(Next_Chain, Snapshot_Section::NEXT_OFFSETS);
+    Matrix(Previus_Chain, Snapshot_Section::PREVIUS_OFFSETS);
+
+    Bind(Guides.Words, Snapshot_Section::LANDMARK_WORDS);
+    Bind(Guides.From, Snapshot_Section::LANDMARK_FROM);
+    Bind(Guides.To, Snapshot_Section::LANDMARK_TO);
+
+    Width = (int)Read_Header->Width;
+    Header = Read_Header;
+}
+
+uint32_t Language_View::Find(string_view Word) const{
+    if (!Is_Open())
+        return Vocabulary::NOT_FOUND;
+
+    uint64_t Hash = Hash_Word(Word);
+    size_t Mask = Word_Table.size() - 1;
+
+    // The table is never full, so the probing always ends on an empty slot.
+    for (size_t Slot = Hash & Mask; Word_Table[Slot] != SNAPSHOT_EMPTY_SLOT; Slot = (Slot + 1) & Mask){
+        uint32_t ID = Word_Table[Slot];
+
+        if (Hashes[ID] == Hash && Get(ID) == Word)
+            return ID;
+    }
+
+    return Vocabulary::NOT_FOUND;
+}
+
+uint32_t Language_View::Next_Word(uint32_t Current, Random& Generator) const{
+    return Next_Chain.Sample_Alias(Current, Generator);
+}
+
+string Language_View::Generate_Thought(int Length, Random& Generator) const{
+    string Result = "";
+
+    if (Size() == 0)
+        return Result;
+
+    uint32_t Current = UINT32_MAX;
+
+    for (int i = 0; i < Length; i++){
+        if (Current != UINT32_MAX)
+            Current = Next_Word(Current, Generator);
+
+        // Start from, or jump out of a dead end into, a random word.
+        if (Current == UINT32_MAX)
+            Current = Generator.Below(Size());
+
+        if (i > 0)
+            Result += " ";
+
+        Result += Get(Current);
+    }
+
+    return Result;
+}
+
+bool Language_View::Djikstra(Path_Finder& Paths, vector<uint32_t>& Result, uint32_t Current, uint32_t End) const{
+    return Paths.Bidirectional(Next_Chain, Previus_Chain, Current, End, Result);
+}
+
+bool Language_View::Landmark_A_Star(Path_Finder& Paths, vector<uint32_t>& Result, uint32_t Current, uint32_t End) const{
+    auto Heuristic = [this, End](uint32_t ID){
+        return Guides.Estimate(ID, End);
+    };
+
+    return Paths.A_Star(Next_Chain, Current, End, Heuristic, Result);
+}
+
+void Language_View::Init_Weight(vector<Weight>& Weights, float Diffuse, vector<pair<Weight,string>> weights, Diffusion_Mode Mode) const{
+    vector<pair<Weight, uint32_t>> Weighted_IDs;
+
+    for (auto& w : weights){
+        uint32_t ID = Find(w.second);
+
+        if (ID != Vocabulary::NOT_FOUND)
+            Weighted_IDs.push_back({w.first, ID});
+    }
+
+    Apply_Weights(Weights, Width, Diffuse, Mode, Cell_Offsets, Cells, Weighted_IDs);
+}
@@ -0,0 +1,90 @@
+#ifndef _LANGUAGE_VIEW_H_
+#define _LANGUAGE_VIEW_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Array_View.h"
+#include "DMC.h"
+#include "Landmarks.h"
+#include "Mapped_File.h"
+#include "Path_Finder.h"
+#include "Random.h"
+#include "Snapshot.h"
+#include "Transition_Matrix.h"
+
+using namespace std;
+
+// Read only Language that runs straight on top of a memory mapped snapshot made by Language::Save.
+// Nothing is copied or fixed up when opened, every array is read from the mapped pages where it lies.
+// So any number of worker processes opening the same snapshot share one physical copy of it through the page cache.
+// The view itself is never written to, the per worker state (Random, Path_Finder, Weights) is given to it by the caller.
+class Language_View{
+public:
+    Mapped_File File;
+
+    // nullptr when the file could not be opened, or was not a snapshot.
+    const Snapshot_Header* Header = nullptr;
+
+    // The sections of the snapshot, see Snapshot_Section for what each holds.
+    Array_View<uint64_t> Word_Offsets;
+    Array_View<char> Characters;
+    Array_View<uint64_t> Hashes;
+    Array_View<uint32_t> Word_Table;
+    Array_View<Vector2> Positions;
+    Array_View<int> Instances;
+    Array_View<float> Importance;
+    Array_View<int> Complexity;
+    Array_View<uint32_t> Cut_Buffer;
+    Array_View<uint32_t> Cell_Offsets;
+    Array_View<uint32_t> Cells;
+
+    int Width = 0;
+
+    Transition_View Next_Chain;
+    Transition_View Previus_Chain;
+
+    // See Language::Guides, picked when the snapshot was saved.
+    // Empty when the language had no landmarks, which leaves the Landmark_A_Star a plain Dijkstra.
+    Landmark_View Guides;
+
+    Language_View(string File_Name);
+
+    bool Is_Open() const{
+        return Header != nullptr;
+    }
+
+    // How many words the language has.
+    size_t Size() const{
+        return Hashes.size();
+    }
+
+    string_view Get(uint32_t ID) const{
+        return string_view(Characters.begin() + Word_Offsets[ID], Word_Offsets[ID + 1] - Word_Offsets[ID]);
+    }
+
+    Vector2 Position(uint32_t ID) const{
+        return Positions[ID];
+    }
+
+    // Returns the id of the word, or Vocabulary::NOT_FOUND.
+    uint32_t Find(string_view Word) const;
+    // Given cut buffers coordinates returns the word id.
+    uint32_t Find(int x, int y) const{
+        return Cut_Buffer[x + (size_t)y * Width];
+    }
+
+    // Teller operations
+    //-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_
+    // See the Teller methods of the same name, these work on word ids instead of Words.
+    uint32_t Next_Word(uint32_t Current, Random& Generator) const;
+    string Generate_Thought(int Length, Random& Generator) const;
+
+    bool Djikstra(Path_Finder& Paths, vector<uint32_t>& Result, uint32_t Current, uint32_t End) const;
+    bool Landmark_A_Star(Path_Finder& Paths, vector<uint32_t>& Result, uint32_t Current, uint32_t End) const;
+
+    void Init_Weight(vector<Weight>& Weights, float Diffuse, vector<pair<Weight,string>> weights, Diffusion_Mode Mode = Diffusion_Mode::SPREAD) const;
+};
+
+#endif
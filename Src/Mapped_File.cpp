@@ -0,0 +1,89 @@
+#include "Mapped_File.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+Mapped_File::Mapped_File(string File_Name, bool Sequential){
+    HANDLE File = CreateFileA(File_Name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+    if (File == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER File_Size;
+    if (!GetFileSizeEx(File, &File_Size) || File_Size.QuadPart == 0){
+        CloseHandle(File);
+        return;
+    }
+
+    HANDLE Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    // The view keeps the mapping object alive, so both handles can be closed right away.
+    if (Mapping){
+        Data = (const char*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(Mapping);
+    }
+    CloseHandle(File);
+
+    if (Data)
+        Size = (size_t)File_Size.QuadPart;
+}
+
+Mapped_File::~Mapped_File(){
+    if (Data)
+        UnmapViewOfFile(Data);
+}
+
+#else
+
+Mapped_File::Mapped_File(string File_Name, bool Sequential){
+    int File = open(File_Name.c_str(), O_RDONLY);
+
+    if (File < 0)
+        return;
+
+    struct stat File_Info;
+
+    // Zero sized files cannot be mapped, the caller falls back to the stream reader.
+    if (fstat(File, &File_Info) != 0 || File_Info.st_size == 0){
+        close(File);
+        return;
+    }
+
+    void* Mapping = mmap(nullptr, File_Info.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+
+    // The mapping holds its own reference to the file.
+    close(File);
+
+    if (Mapping == MAP_FAILED)
+        return;
+
+    // The tokenizer walks the file front to back exactly once.
+    if (Sequential)
+        madvise(Mapping, File_Info.st_size, MADV_SEQUENTIAL);
+
+    Data = (const char*)Mapping;
+    Size = File_Info.st_size;
+}
+
+Mapped_File::~Mapped_File(){
+    if (Data)
+        munmap((void*)Data, Size);
+}
+
+#endif
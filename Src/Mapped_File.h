@@ -0,0 +1,35 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Read only view of a whole file, served straight from the OS page cache.
+// The pages stay mapped for as long as this object lives.
+class Mapped_File{
+public:
+    const char* Data = nullptr;
+    size_t Size = 0;
+
+    Mapped_File(){}
+    // Sequential tells the OS the file is read front to back once, so it reads ahead aggressively.
+    // Files that are looked around in, like snapshots, should turn it off.
+    Mapped_File(string File_Name, bool Sequential = true);
+    ~Mapped_File();
+
+    // The mapping has a single owner.
+    Mapped_File(const Mapped_File&) = delete;
+    Mapped_File& operator=(const Mapped_File&) = delete;
+
+    bool Is_Open(){
+        return Data != nullptr;
+    }
+
+    string_view View(){
+        return string_view(Data, Size);
+    }
+};
+
+#endif
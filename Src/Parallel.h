@@ -0,0 +1,36 @@
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// How many threads the parallel passes use, all the hardware threads by default.
+inline unsigned Thread_Count(){
+    unsigned Count = thread::hardware_concurrency();
+    return Count > 0 ? Count : 1;
+}
+
+// Splits [0, Count) into one contiguous shard per thread, and runs Function(Thread, Begin, End) for each shard.
+// Returns once every shard is done. The calling thread works on the first shard itself.
+// Small jobs are not worth starting threads for, so every thread gets at least Minimum_Per_Thread items.
+template<typename F>
+void Parallel_For(size_t Count, F Function, size_t Minimum_Per_Thread = 1 << 14, unsigned Threads = Thread_Count()){
+    size_t Shards = max<size_t>(1, min<size_t>(Threads, Count / max<size_t>(Minimum_Per_Thread, 1)));
+
+    vector<thread> Workers;
+
+    for (size_t Shard = 1; Shard < Shards; Shard++){
+        Workers.emplace_back(Function, (unsigned)Shard, Count * Shard / Shards, Count * (Shard + 1) / Shards);
+    }
+
+    Function(0u, (size_t)0, Count / Shards);
+
+    for (auto& Worker : Workers){
+        Worker.join();
+    }
+}
+
+#endif
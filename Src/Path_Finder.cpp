@@ -0,0 +1,236 @@
+#include "Path_Finder.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+void Search_Space::Reset(size_t Word_Count){
+    if (Seen.size() < Word_Count){
+        Distance.resize(Word_Count);
+        Parent.resize(Word_Count);
+        Heap_Index.resize(Word_Count);
+        Seen.resize(Word_Count, 0);
+    }
+
+    // Once every 4 billion searches the stamps wrap around, and then the old ones need to be cleared for real.
+    if (++Generation == 0){
+        fill(Seen.begin(), Seen.end(), 0);
+        Generation = 1;
+    }
+
+    Heap.clear();
+}
+
+bool Search_Space::Relax(uint32_t ID, uint32_t From, float New_Distance, float Key){
+    if (!Reached(ID)){
+        Seen[ID] = Generation;
+        Distance[ID] = New_Distance;
+        Parent[ID] = From;
+
+        Heap_Index[ID] = (uint32_t)Heap.size();
+        Heap.push_back({Key, ID});
+        Sift_Up(Heap_Index[ID]);
+
+        return true;
+    }
+
+    if (Heap_Index[ID] == SETTLED || New_Distance >= Distance[ID])
+        return false;
+
+    Distance[ID] = New_Distance;
+    Parent[ID] = From;
+
+    // The key goes down along with the distance, so the word can only move up.
+    Heap[Heap_Index[ID]].Key = Key;
+    Sift_Up(Heap_Index[ID]);
+
+    return true;
+}
+
+uint32_t Search_Space::Pop(){
+    uint32_t Result = Heap[0].ID;
+    Heap_Index[Result] = SETTLED;
+
+    Heap[0] = Heap.back();
+    Heap.pop_back();
+
+    if (Heap.size() > 0){
+        Heap_Index[Heap[0].ID] = 0;
+        Sift_Down(0);
+    }
+
+    return Result;
+}
+
+void Search_Space::Sift_Up(uint32_t Index){
+    Heap_Entry Moving = Heap[Index];
+
+    while (Index > 0){
+        uint32_t Up = (Index - 1) / ARITY;
+
+        if (Heap[Up].Key <= Moving.Key)
+            break;
+
+        Heap[Index] = Heap[Up];
+        Heap_Index[Heap[Index].ID] = Index;
+        Index = Up;
+    }
+
+    Heap[Index] = Moving;
+    Heap_Index[Moving.ID] = Index;
+}
+
+void Search_Space::Sift_Down(uint32_t Index){
+    Heap_Entry Moving = Heap[Index];
+    uint32_t Size = (uint32_t)Heap.size();
+
+    while (true){
+        uint32_t First_Child = Index * ARITY + 1;
+
+        if (First_Child >= Size)
+            break;
+
+        uint32_t Smallest = First_Child;
+        uint32_t Last_Child = min(First_Child + ARITY, Size);
+
+        for (uint32_t Child = First_Child + 1; Child < Last_Child; Child++){
+            if (Heap[Child].Key < Heap[Smallest].Key)
+                Smallest = Child;
+        }
+
+        if (Moving.Key <= Heap[Smallest].Key)
+            break;
+
+        Heap[Index] = Heap[Smallest];
+        Heap_Index[Heap[Index].ID] = Index;
+        Index = Smallest;
+    }
+
+    Heap[Index] = Moving;
+    Heap_Index[Moving.ID] = Index;
+}
+
+void Search_Space::Trace(uint32_t ID, vector<uint32_t>& Result){
+    size_t First = Result.size();
+
+    while (true){
+        Result.push_back(ID);
+
+        if (Parent[ID] == ID)
+            break;
+
+        ID = Parent[ID];
+    }
+
+    reverse(Result.begin() + First, Result.end());
+}
+
+// Settles every word the Chain reaches from Start, where Cost(Edge) is the cost of the edge.
+template<typename C>
+void Settle_All(Search_Space& Space, Transition_View Chain, uint32_t Start, C Cost, vector<float>& Result, size_t& Expanded){
+    size_t Word_Count = Chain.Offsets.size() - 1;
+
+    Result.assign(Word_Count, numeric_limits<float>::infinity());
+    Expanded = 0;
+
+    Space.Reset(Word_Count);
+    Space.Relax(Start, Start, 0, 0);
+
+    while (!Space.Empty()){
+        uint32_t Current = Space.Pop();
+        Expanded++;
+
+        float Distance = Space.Distance[Current];
+        Result[Current] = Distance;
+
+        for (uint32_t Edge = Chain.Offsets[Current]; Edge < Chain.Offsets[Current + 1]; Edge++){
+            float New_Distance = Distance + Cost(Edge);
+
+            Space.Relax(Chain.Targets[Edge], Current, New_Distance, New_Distance);
+        }
+    }
+}
+
+void Path_Finder::Distances_From(Transition_View Next, uint32_t Start, vector<float>& Result){
+    Settle_All(Forward, Next, Start, [&](uint32_t Edge){ return Next.Costs[Edge]; }, Result, Expanded);
+}
+
+void Path_Finder::Distances_To(Transition_View Next, Transition_View Previus, uint32_t End, vector<float>& Result){
+    Settle_All(Backward, Previus, End, [&](uint32_t Edge){ return Next.Costs[Previus.Mirror[Edge]]; }, Result, Expanded);
+}
+
+bool Path_Finder::Dijkstra(Transition_View Chain, uint32_t Start, uint32_t End, vector<uint32_t>& Result){
+    // Plain Dijkstra is A* that knows nothing about the distance left.
+    return A_Star(Chain, Start, End, [](uint32_t){ return 0.0f; }, Result);
+}
+
+bool Path_Finder::Bidirectional(Transition_View Next, Transition_View Previus, uint32_t Start, uint32_t End, vector<uint32_t>& Result){
+    Result.clear();
+    Expanded = 0;
+
+    Forward.Reset(Next.Offsets.size() - 1);
+    Backward.Reset(Previus.Offsets.size() - 1);
+
+    Forward.Relax(Start, Start, 0, 0);
+    Backward.Relax(End, End, 0, 0);
+
+    // The cheapest full path found so far goes through Meeting_Point.
+    float Best = Start == End ? 0 : numeric_limits<float>::infinity();
+    uint32_t Meeting_Point = Start == End ? Start : UINT32_MAX;
+
+    while (!Forward.Empty() && !Backward.Empty()){
+        // No path through the unsettled words can beat this anymore.
+        if (Forward.Top_Key() + Backward.Top_Key() >= Best)
+            break;
+
+        Expanded++;
+
+        // Grow the smaller frontier, so the two stay balanced.
+        if (Forward.Heap.size() <= Backward.Heap.size()){
+            uint32_t Current = Forward.Pop();
+            float Distance = Forward.Distance[Current];
+
+            for (uint32_t Edge = Next.Offsets[Current]; Edge < Next.Offsets[Current + 1]; Edge++){
+                uint32_t Target = Next.Targets[Edge];
+                float New_Distance = Distance + Next.Costs[Edge];
+
+                Forward.Relax(Target, Current, New_Distance, New_Distance);
+
+                if (Backward.Reached(Target) && New_Distance + Backward.Distance[Target] < Best){
+                    Best = New_Distance + Backward.Distance[Target];
+                    Meeting_Point = Target;
+                }
+            }
+        }
+        else{
+            uint32_t Current = Backward.Pop();
+            float Distance = Backward.Distance[Current];
+
+            for (uint32_t Edge = Previus.Offsets[Current]; Edge < Previus.Offsets[Current + 1]; Edge++){
+                uint32_t Source = Previus.Targets[Edge];
+                float New_Distance = Distance + Next.Costs[Previus.Mirror[Edge]];
+
+                Backward.Relax(Source, Current, New_Distance, New_Distance);
+
+                if (Forward.Reached(Source) && New_Distance + Forward.Distance[Source] < Best){
+                    Best = New_Distance + Forward.Distance[Source];
+                    Meeting_Point = Source;
+                }
+            }
+        }
+    }
+
+    if (Meeting_Point == UINT32_MAX)
+        return false;
+
+    // Start to the meeting point, then follow the backward parents on to the End.
+    Forward.Trace(Meeting_Point, Result);
+
+    for (uint32_t ID = Meeting_Point; ID != End; ){
+        ID = Backward.Parent[ID];
+        Result.push_back(ID);
+    }
+
+    return true;
+}
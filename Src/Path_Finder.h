@@ -0,0 +1,148 @@
+#ifndef _PATH_FINDER_H_
+#define _PATH_FINDER_H_
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Transition_Matrix.h"
+
+using namespace std;
+
+// One direction of a shortest path search over word ids.
+// The arrays are kept between searches, and a generation stamp tells which entries belong to the current search.
+// So starting a new search does not clear or allocate anything.
+class Search_Space{
+public:
+    // Heap_Index of a word that has already been taken out of the heap.
+    static constexpr uint32_t SETTLED = UINT32_MAX;
+
+    // Children per heap node, a wider heap is shallower and its children share cache lines.
+    static constexpr uint32_t ARITY = 4;
+
+    struct Heap_Entry{
+        float Key;
+        uint32_t ID;
+    };
+
+    vector<float> Distance;
+    vector<uint32_t> Parent;
+    vector<uint32_t> Heap_Index;
+    // The generation in which the word was last reached.
+    vector<uint32_t> Seen;
+    uint32_t Generation = 0;
+
+    // Indexed min heap of the reached but not settled words.
+    vector<Heap_Entry> Heap;
+
+    // Starts a new search over Word_Count words.
+    void Reset(size_t Word_Count);
+
+    bool Reached(uint32_t ID){
+        return Seen[ID] == Generation;
+    }
+
+    bool Settled(uint32_t ID){
+        return Reached(ID) && Heap_Index[ID] == SETTLED;
+    }
+
+    // Offers the word a new distance through From, and queues it with Key.
+    // Returns false when the word already had a shorter distance, or was settled.
+    bool Relax(uint32_t ID, uint32_t From, float New_Distance, float Key);
+
+    bool Empty(){
+        return Heap.size() == 0;
+    }
+
+    float Top_Key(){
+        return Heap[0].Key;
+    }
+
+    // Takes out and settles the word with the smallest key.
+    uint32_t Pop();
+
+    // Walks the parents from the word back to the start of the search.
+    // The result is ordered from the start to the word.
+    void Trace(uint32_t ID, vector<uint32_t>& Result);
+
+    void Sift_Up(uint32_t Index);
+    void Sift_Down(uint32_t Index);
+};
+
+// Shortest paths through the Markov chain, where stepping over an edge costs -log(probability).
+// So the cheapest path is the most probable chain of words.
+// Works on Transition_Views, so a Transition_Matrix and a memory mapped snapshot are searched the same way.
+class Path_Finder{
+public:
+    Search_Space Forward;
+    Search_Space Backward;
+
+    // How many words the last search settled.
+    size_t Expanded = 0;
+
+    // Finds the most probable path from Start to End, and fills Result with the word ids from Start to End.
+    // Returns false if End cannot be reached.
+    bool Dijkstra(Transition_View Chain, uint32_t Start, uint32_t End, vector<uint32_t>& Result);
+
+    // Dijkstra guided by Heuristic(ID), an estimate of the cost left from the word to End.
+    // Words that look far from End are put off, so much less of the chain gets settled.
+    // The path is still the most probable one, as long as the estimate never goes over the real cost.
+    // An infinite estimate means the word cannot reach End at all, so it is never queued.
+    template<typename H>
+    bool A_Star(Transition_View Chain, uint32_t Start, uint32_t End, H Heuristic, vector<uint32_t>& Result){
+        Result.clear();
+        Expanded = 0;
+
+        Forward.Reset(Chain.Offsets.size() - 1);
+
+        float Start_Estimate = Heuristic(Start);
+
+        if (isinf(Start_Estimate))
+            return false;
+
+        // The start is its own parent, which is where tracing stops.
+        Forward.Relax(Start, Start, 0, Start_Estimate);
+
+        while (!Forward.Empty()){
+            uint32_t Current = Forward.Pop();
+            Expanded++;
+
+            if (Current == End){
+                Forward.Trace(End, Result);
+                return true;
+            }
+
+            float Distance = Forward.Distance[Current];
+
+            for (uint32_t Edge = Chain.Offsets[Current]; Edge < Chain.Offsets[Current + 1]; Edge++){
+                uint32_t Target = Chain.Targets[Edge];
+                float New_Distance = Distance + Chain.Costs[Edge];
+
+                // Settled words are final, no need to estimate them again.
+                if (Forward.Settled(Target))
+                    continue;
+
+                float Estimate = Heuristic(Target);
+
+                if (isinf(Estimate))
+                    continue;
+
+                Forward.Relax(Target, Current, New_Distance, New_Distance + Estimate);
+            }
+        }
+
+        return false;
+    }
+
+    // Same as Dijkstra, but searches forward from Start through the Next chain and backwards from End through the Previus chain at the same time.
+    // Stops once the two frontiers cannot find a cheaper meeting point, which usually settles far fewer words than searching from one end.
+    // Previus has to be the reverse of Next, with its Mirror linked.
+    bool Bidirectional(Transition_View Next, Transition_View Previus, uint32_t Start, uint32_t End, vector<uint32_t>& Result);
+
+    // Fills Result with the cost of the most probable path from Start to every word, infinity for the words Start cannot reach.
+    void Distances_From(Transition_View Next, uint32_t Start, vector<float>& Result);
+    // Same as above, but the cost from every word to End, searched backwards through the Previus chain with the costs of the Next chain.
+    void Distances_To(Transition_View Next, Transition_View Previus, uint32_t End, vector<float>& Result);
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+#include <cstdint>
+
+using namespace std;
+
+// xoshiro256** pseudo random generator.
+// Much faster than rand() and has no global state, so every Teller can have its own.
+class Random{
+public:
+    uint64_t State[4];
+
+    // Spreads the seed over the whole state with splitmix64, so even small seeds give a good state.
+    Random(uint64_t Seed = 0x9E3779B97F4A7C15ull){
+        for (auto& s : State){
+            Seed += 0x9E3779B97F4A7C15ull;
+
+            uint64_t z = Seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            s = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t Next(){
+        uint64_t Result = Rotate(State[1] * 5, 7) * 9;
+        uint64_t t = State[1] << 17;
+
+        State[2] ^= State[0];
+        State[3] ^= State[1];
+        State[1] ^= State[2];
+        State[0] ^= State[3];
+
+        State[2] ^= t;
+        State[3] = Rotate(State[3], 45);
+
+        return Result;
+    }
+
+    // Returns a number in [0, 1).
+    float Uniform(){
+        return (Next() >> 40) * (1.0f / (1 << 24));
+    }
+
+    // Returns a number in [0, Count), without the bias of the modulo.
+    // Lemire's multiply and shift, the low half of the product tells when the draw landed in the uneven leftover and has to be drawn again.
+    // The division for that leftover is only done in the rare case the low half is small enough to be in it.
+    uint32_t Below(uint32_t Count){
+        uint64_t Product = (Next() >> 32) * Count;
+        uint32_t Low = (uint32_t)Product;
+
+        if (Low < Count){
+            uint32_t Leftover = (0u - Count) % Count;
+
+            while (Low < Leftover){
+                Product = (Next() >> 32) * Count;
+                Low = (uint32_t)Product;
+            }
+        }
+
+        return (uint32_t)(Product >> 32);
+    }
+
+    static uint64_t Rotate(uint64_t x, int k){
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+#endif
@@ -0,0 +1,377 @@
+#include "DMC.h"
+#include "Mapped_File.h"
+#include "Snapshot.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+// The attribute columns go into the snapshot as they are, so they have to have the layout of the sections.
+static_assert(sizeof(Vector2) == 2 * sizeof(int32_t) && sizeof(int) == sizeof(int32_t), "Snapshot sections expect 32 bit ints");
+
+// Size of one element of each section, in the order of Snapshot_Section.
+static constexpr size_t SECTION_ELEMENT_SIZES[(size_t)Snapshot_Section::COUNT] = {
+    sizeof(uint64_t), sizeof(char), sizeof(uint64_t), sizeof(uint32_t),
+    2 * sizeof(int32_t), sizeof(int32_t), sizeof(float), sizeof(int32_t),
+    sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t),
+    sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(float), sizeof(float), sizeof(float), sizeof(uint32_t), sizeof(float), sizeof(uint32_t),
+    sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(float), sizeof(float), sizeof(float), sizeof(uint32_t), sizeof(float), sizeof(uint32_t),
+    sizeof(uint32_t), sizeof(float), sizeof(float),
+};
+
+// Checks that every one of the Count ids is below the Limit, so it can be used as an index.
+bool All_Below(const uint32_t* IDs, size_t Count, uint64_t Limit){
+    for (size_t i = 0; i < Count; i++){
+        if (IDs[i] >= Limit)
+            return false;
+    }
+
+    return true;
+}
+
+// Checks that the arrays of one matrix agree with each other, and that every id in them points inside what it indexes.
+// Mirror_Edges is the edge count of the other matrix, which the Mirror points into.
+// Bit n of Required is set when the n'th array after the offsets, like 1 << 5 for the costs, has to have a value per edge.
+// The other arrays may also be left out.
+bool Check_Matrix(const Snapshot_Header* Header, const char* Data, Snapshot_Section First, size_t Mirror_Edges, uint32_t Required){
+    size_t Offsets = Header->Count<uint32_t>(First);
+
+    // A language without words may have no matrix.
+    if (Offsets == 0 && Header->Word_Count == 0)
+        return true;
+
+    if (Offsets != Header->Word_Count + 1)
+        return false;
+
+    const uint32_t* Row_Offsets = Header->Get<uint32_t>(Data, First);
+    size_t Edges = Row_Offsets[Header->Word_Count];
+
+    if (Row_Offsets[0] != 0)
+        return false;
+
+    for (size_t ID = 0; ID < Header->Word_Count; ID++){
+        if (Row_Offsets[ID] > Row_Offsets[ID + 1])
+            return false;
+    }
+
+    // The targets and the counts are what the rest is built from, so they are always there.
+    Required |= 1 << 1 | 1 << 2;
+
+    // Every other array is either not built or has a value per edge.
+    for (uint32_t Array = 1; Array < SNAPSHOT_MATRIX_SECTIONS; Array++){
+        size_t Count = Header->Sections[(size_t)(First + Array)].Size / SECTION_ELEMENT_SIZES[(size_t)(First + Array)];
+
+        if (Count != Edges && (Count != 0 || (Required >> Array & 1)))
+            return false;
+    }
+
+    const uint32_t* Targets = Header->Get<uint32_t>(Data, First + 1);
+    const uint32_t* Mirror = Header->Get<uint32_t>(Data, First + 6);
+    const uint32_t* Alias = Header->Get<uint32_t>(Data, First + 8);
+
+    if (!All_Below(Targets, Edges, Header->Word_Count) || !All_Below(Mirror, Header->Count<uint32_t>(First + 6), Mirror_Edges))
+        return false;
+
+    // The aliases are indexes within their own row.
+    if (Header->Count<uint32_t>(First + 8) != 0){
+        for (size_t ID = 0; ID < Header->Word_Count; ID++){
+            if (!All_Below(Alias + Row_Offsets[ID], Row_Offsets[ID + 1] - Row_Offsets[ID], Row_Offsets[ID + 1] - Row_Offsets[ID]))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+const Snapshot_Header* Snapshot_Header::Read(const char* Data, size_t Size){
+    if (Size < sizeof(Snapshot_Header))
+        return nullptr;
+
+    const Snapshot_Header* Header = (const Snapshot_Header*)Data;
+
+    if (memcmp(Header->Magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || Header->Version != SNAPSHOT_VERSION || Header->Byte_Order != 0x01020304)
+        return nullptr;
+
+    for (size_t i = 0; i < (size_t)Snapshot_Section::COUNT; i++){
+        const Range& Section = Header->Sections[i];
+
+        if (Section.Offset % SNAPSHOT_ALIGNMENT != 0 || Section.Offset > Size || Section.Size > Size - Section.Offset || Section.Size % SECTION_ELEMENT_SIZES[i] != 0)
+            return nullptr;
+    }
+
+    uint64_t Word_Count = Header->Word_Count;
+
+    if (Header->Count<uint64_t>(Snapshot_Section::WORD_OFFSETS) != Word_Count + 1 ||
+        Header->Count<uint64_t>(Snapshot_Section::WORD_HASHES) != Word_Count ||
+        Header->Count<int32_t>(Snapshot_Section::INSTANCES) != Word_Count ||
+        Header->Count<float>(Snapshot_Section::IMPORTANCE) != Word_Count ||
+        Header->Count<int32_t>(Snapshot_Section::COMPLEXITY) != Word_Count ||
+        Header->Count<int32_t>(Snapshot_Section::POSITIONS) != Word_Count * 2 ||
+        Header->Count<uint32_t>(Snapshot_Section::CUT_BUFFER) != Header->Cell_Count ||
+        Header->Width < 0 || Header->Width > INT32_MAX || (uint64_t)(Header->Width * Header->Width) > Header->Cell_Count)
+        return nullptr;
+
+    // The word table has to be a power of two, with room left for the probing to end.
+    size_t Table_Size = Header->Count<uint32_t>(Snapshot_Section::WORD_TABLE);
+
+    if (Table_Size <= Word_Count || (Table_Size & (Table_Size - 1)) != 0)
+        return nullptr;
+
+    // Every slot is a word or empty, and a lookup only ends on an empty slot, so there has to be one.
+    const uint32_t* Word_Table = Header->Get<uint32_t>(Data, Snapshot_Section::WORD_TABLE);
+    size_t Empty_Slots = 0;
+
+    for (size_t Slot = 0; Slot < Table_Size; Slot++){
+        if (Word_Table[Slot] == SNAPSHOT_EMPTY_SLOT)
+            Empty_Slots++;
+        else if (Word_Table[Slot] >= Word_Count)
+            return nullptr;
+    }
+
+    if (Empty_Slots == 0)
+        return nullptr;
+
+    // The Cut_Buffer holds word ids.
+    if (!All_Below(Header->Get<uint32_t>(Data, Snapshot_Section::CUT_BUFFER), Header->Cell_Count, Word_Count))
+        return nullptr;
+
+    // Every word has to be inside the characters.
+    const uint64_t* Word_Offsets = Header->Get<uint64_t>(Data, Snapshot_Section::WORD_OFFSETS);
+
+    if (Word_Offsets[0] != 0 || Word_Offsets[Word_Count] != Header->Sections[(size_t)Snapshot_Section::CHARACTERS].Size)
+        return nullptr;
+
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        if (Word_Offsets[ID] > Word_Offsets[ID + 1])
+            return nullptr;
+    }
+
+    // Every word has to have its cells, and every cell of the map has to belong to a word.
+    const uint32_t* Cell_Offsets = Header->Get<uint32_t>(Data, Snapshot_Section::CELL_OFFSETS);
+
+    if (Header->Count<uint32_t>(Snapshot_Section::CELL_OFFSETS) != Word_Count + 1 ||
+        Header->Count<uint32_t>(Snapshot_Section::CELLS) != (uint64_t)(Header->Width * Header->Width) ||
+        Cell_Offsets[0] != 0 || Cell_Offsets[Word_Count] != Header->Count<uint32_t>(Snapshot_Section::CELLS))
+        return nullptr;
+
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        if (Cell_Offsets[ID] > Cell_Offsets[ID + 1])
+            return nullptr;
+    }
+
+    if (!All_Below(Header->Get<uint32_t>(Data, Snapshot_Section::CELLS), Header->Count<uint32_t>(Snapshot_Section::CELLS), (uint64_t)(Header->Width * Header->Width)))
+        return nullptr;
+
+    // The Mirror of each matrix points into the edges of the other one.
+    size_t Next_Edges = Header->Count<uint32_t>(Snapshot_Section::NEXT_TARGETS);
+    size_t Previus_Edges = Header->Count<uint32_t>(Snapshot_Section::PREVIUS_TARGETS);
+
+    // The views sample the Next_Chain through its alias tables, and search both chains by the costs of the Next_Chain.
+    // The Probabilities and Cumulative are kept as the Normalize leaves them, for both.
+    uint32_t Next_Required = 1 << 3 | 1 << 4 | 1 << 5 | 1 << 7 | 1 << 8;
+    uint32_t Previus_Required = 1 << 3 | 1 << 4 | 1 << 5 | 1 << 6;
+
+    if (!Check_Matrix(Header, Data, Snapshot_Section::NEXT_OFFSETS, Previus_Edges, Next_Required) || !Check_Matrix(Header, Data, Snapshot_Section::PREVIUS_OFFSETS, Next_Edges, Previus_Required))
+        return nullptr;
+
+    // Every landmark is a word, and has a bound to and from every word.
+    size_t Landmark_Count = Header->Count<uint32_t>(Snapshot_Section::LANDMARK_WORDS);
+
+    if (Header->Count<float>(Snapshot_Section::LANDMARK_FROM) != Landmark_Count * Word_Count ||
+        Header->Count<float>(Snapshot_Section::LANDMARK_TO) != Landmark_Count * Word_Count ||
+        !All_Below(Header->Get<uint32_t>(Data, Snapshot_Section::LANDMARK_WORDS), Landmark_Count, Word_Count))
+        return nullptr;
+
+    return Header;
+}
+
+bool Language::Save(string File_Name){
+    ofstream File(File_Name, ios::binary | ios::trunc);
+
+    if (!File.is_open()){
+        cout << "Error while opening file" << endl;
+        return false;
+    }
+
+    Snapshot_Header Header = {};
+    memcpy(Header.Magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    Header.Version = SNAPSHOT_VERSION;
+    Header.Byte_Order = 0x01020304;
+    Header.Word_Count = Dictionary.Size();
+    Header.Cell_Count = Cut_Buffer.size();
+    Header.Width = Width;
+
+    // The header is written again at the end, once the section ranges are known.
+    File.write((const char*)&Header, sizeof(Header));
+
+    auto Write = [&](Snapshot_Section Section, const void* Data, size_t Size){
+        static const char Padding[SNAPSHOT_ALIGNMENT] = {};
+
+        size_t Offset = File.tellp();
+        size_t Aligned = (Offset + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+
+        File.write(Padding, Aligned - Offset);
+        File.write((const char*)Data, Size);
+
+        Header.Sections[(size_t)Section] = {Aligned, Size};
+    };
+
+    size_t Word_Count = Dictionary.Size();
+
+    // The words are scattered over the Dictionary blocks, so they are packed back to back here.
+    vector<uint64_t> Word_Offsets(Word_Count + 1, 0);
+    string Characters;
+
+    for (uint32_t ID = 0; ID < Word_Count; ID++){
+        Characters.append(Dictionary.Get(ID));
+        Word_Offsets[ID + 1] = Characters.size();
+    }
+
+    // At most half full, so a lookup of a missing word ends quickly.
+    size_t Table_Size = 64;
+
+    while (Table_Size < Word_Count * 2)
+        Table_Size *= 2;
+
+    vector<uint32_t> Word_Table(Table_Size, SNAPSHOT_EMPTY_SLOT);
+
+    for (uint32_t ID = 0; ID < Word_Count; ID++){
+        size_t Slot = Dictionary.Hashes[ID] & (Table_Size - 1);
+
+        while (Word_Table[Slot] != SNAPSHOT_EMPTY_SLOT)
+            Slot = (Slot + 1) & (Table_Size - 1);
+
+        Word_Table[Slot] = ID;
+    }
+
+    Write(Snapshot_Section::WORD_OFFSETS, Word_Offsets.data(), Word_Offsets.size() * sizeof(uint64_t));
+    Write(Snapshot_Section::CHARACTERS, Characters.data(), Characters.size());
+    Write(Snapshot_Section::WORD_HASHES, Dictionary.Hashes.data(), Word_Count * sizeof(uint64_t));
+    Write(Snapshot_Section::WORD_TABLE, Word_Table.data(), Word_Table.size() * sizeof(uint32_t));
+
+    // The attribute columns are written as they are.
+    Write(Snapshot_Section::POSITIONS, Positions.data(), Positions.size() * sizeof(Vector2));
+    Write(Snapshot_Section::INSTANCES, Instances.data(), Instances.size() * sizeof(int));
+    Write(Snapshot_Section::IMPORTANCE, Importance.data(), Importance.size() * sizeof(float));
+    Write(Snapshot_Section::COMPLEXITY, Complexity.data(), Complexity.size() * sizeof(int));
+
+    Write(Snapshot_Section::CUT_BUFFER, Cut_Buffer.data(), Cut_Buffer.size() * sizeof(uint32_t));
+    Write(Snapshot_Section::CELL_OFFSETS, Cell_Offsets.data(), Cell_Offsets.size() * sizeof(uint32_t));
+    Write(Snapshot_Section::CELLS, Cells.data(), Cells.size() * sizeof(uint32_t));
+
+    auto Write_Matrix = [&](Snapshot_Section First, Transition_Matrix& Chain){
+        Write(First + 0, Chain.Offsets.data(), Chain.Offsets.size() * sizeof(uint32_t));
+        Write(First + 1, Chain.Targets.data(), Chain.Targets.size() * sizeof(uint32_t));
+        Write(First + 2, Chain.Counts.data(), Chain.Counts.size() * sizeof(uint32_t));
+        Write(First + 3, Chain.Probabilities.data(), Chain.Probabilities.size() * sizeof(float));
+        Write(First + 4, Chain.Cumulative.data(), Chain.Cumulative.size() * sizeof(float));
+        Write(First + 5, Chain.Costs.data(), Chain.Costs.size() * sizeof(float));
+        Write(First + 6, Chain.Mirror.data(), Chain.Mirror.size() * sizeof(uint32_t));
+        Write(First + 7, Chain.Alias_Probability.data(), Chain.Alias_Probability.size() * sizeof(float));
+        Write(First + 8, Chain.Alias.data(), Chain.Alias.size() * sizeof(uint32_t));
+    };
+
+    Write_Matrix(Snapshot_Section::NEXT_OFFSETS, Next_Chain);
+    Write_Matrix(Snapshot_Section::PREVIUS_OFFSETS, Previus_Chain);
+
+    // The landmarks are picked here, once, so the views mapping the snapshot do not each have to pick their own.
+    Path_Finder Paths;
+    Update_Landmarks(Paths);
+
+    Write(Snapshot_Section::LANDMARK_WORDS, Guides.Words.data(), Guides.Words.size() * sizeof(uint32_t));
+    Write(Snapshot_Section::LANDMARK_FROM, Guides.From.data(), Guides.From.size() * sizeof(float));
+    Write(Snapshot_Section::LANDMARK_TO, Guides.To.data(), Guides.To.size() * sizeof(float));
+
+    File.seekp(0);
+    File.write((const char*)&Header, sizeof(Header));
+
+    if (!File.good()){
+        cout << "Error while writing file" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Copies the whole section into the vector at once.
+template<typename T>
+void Copy_Section(const Snapshot_Header* Header, const char* Data, Snapshot_Section Section, vector<T>& Result){
+    const T* Begin = Header->Get<T>(Data, Section);
+
+    Result.assign(Begin, Begin + Header->Count<T>(Section));
+}
+
+bool Language::Load(string File_Name){
+    Mapped_File Mapped(File_Name);
+
+    if (!Mapped.Is_Open()){
+        cout << "Error while opening file" << endl;
+        return false;
+    }
+
+    const char* Data = Mapped.Data;
+    const Snapshot_Header* Header = Snapshot_Header::Read(Data, Mapped.Size);
+
+    if (!Header){
+        cout << "Not a snapshot of version " << SNAPSHOT_VERSION << ": " << File_Name << endl;
+        return false;
+    }
+
+    Language_Name = File_Name.substr(File_Name.find_last_of("/\\") + 1);
+    Language_Name = Language_Name.substr(0, Language_Name.find_last_of("."));
+
+    size_t Word_Count = Header->Word_Count;
+
+    Dictionary.Load(
+        string_view(Header->Get<char>(Data, Snapshot_Section::CHARACTERS), Header->Sections[(size_t)Snapshot_Section::CHARACTERS].Size),
+        Header->Get<uint64_t>(Data, Snapshot_Section::WORD_OFFSETS),
+        Header->Get<uint64_t>(Data, Snapshot_Section::WORD_HASHES),
+        Word_Count
+    );
+
+    for (uint32_t ID = 0; ID < Word_Count; ID++){
+        Get_Markov_Word(ID);
+    }
+
+    Copy_Section(Header, Data, Snapshot_Section::POSITIONS, Positions);
+    Copy_Section(Header, Data, Snapshot_Section::INSTANCES, Instances);
+    Copy_Section(Header, Data, Snapshot_Section::IMPORTANCE, Importance);
+    Copy_Section(Header, Data, Snapshot_Section::COMPLEXITY, Complexity);
+
+    Copy_Section(Header, Data, Snapshot_Section::CUT_BUFFER, Cut_Buffer);
+    Copy_Section(Header, Data, Snapshot_Section::CELL_OFFSETS, Cell_Offsets);
+    Copy_Section(Header, Data, Snapshot_Section::CELLS, Cells);
+    Width = (int)Header->Width;
+
+    auto Load_Matrix = [&](Snapshot_Section First, Transition_Matrix& Chain){
+        Copy_Section(Header, Data, First + 0, Chain.Offsets);
+        Copy_Section(Header, Data, First + 1, Chain.Targets);
+        Copy_Section(Header, Data, First + 2, Chain.Counts);
+        Copy_Section(Header, Data, First + 3, Chain.Probabilities);
+        Copy_Section(Header, Data, First + 4, Chain.Cumulative);
+        Copy_Section(Header, Data, First + 5, Chain.Costs);
+        Copy_Section(Header, Data, First + 6, Chain.Mirror);
+        Copy_Section(Header, Data, First + 7, Chain.Alias_Probability);
+        Copy_Section(Header, Data, First + 8, Chain.Alias);
+    };
+
+    Load_Matrix(Snapshot_Section::NEXT_OFFSETS, Next_Chain);
+    Load_Matrix(Snapshot_Section::PREVIUS_OFFSETS, Previus_Chain);
+    Chain_Generation++;
+
+    Copy_Section(Header, Data, Snapshot_Section::LANDMARK_WORDS, Guides.Words);
+    Copy_Section(Header, Data, Snapshot_Section::LANDMARK_FROM, Guides.From);
+    Copy_Section(Header, Data, Snapshot_Section::LANDMARK_TO, Guides.To);
+    Guides_Generation = Chain_Generation;
+
+    // Every edge of the Next_Chain is one counted pair, so a later Finalize builds the chains from the old and the new text together.
+    for (uint32_t From = 0; From + 1 < Next_Chain.Offsets.size(); From++){
+        for (uint32_t Edge = Next_Chain.Offsets[From]; Edge < Next_Chain.Offsets[From + 1]; Edge++){
+            Transitions.Add(From, Next_Chain.Targets[Edge], Next_Chain.Counts[Edge]);
+        }
+    }
+
+    return true;
+}
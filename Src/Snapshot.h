@@ -0,0 +1,122 @@
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Binary snapshot of a built Language.
+// The file is a header followed by flat arrays, each starting at a 64 byte aligned offset.
+// Nothing in it is a pointer, so it can be used straight from a memory mapping, by any number of processes at once.
+// Numbers are stored in the byte order of the machine that saved it.
+
+static constexpr char SNAPSHOT_MAGIC[8] = "DMCSNAP";
+
+// Bumped every time the header or the sections change, older snapshots are then refused instead of misread.
+static constexpr uint32_t SNAPSHOT_VERSION = 4;
+
+static constexpr size_t SNAPSHOT_ALIGNMENT = 64;
+
+// Every array in the snapshot, in the order they are written.
+enum class Snapshot_Section : uint32_t{
+    // Word id to its start in the CHARACTERS, with one extra offset for the end of the last word. (uint64_t)
+    WORD_OFFSETS,
+    // All the words back to back, without separators. (char)
+    CHARACTERS,
+    // Word id to the Hash_Word of the word. (uint64_t)
+    WORD_HASHES,
+    // Open addressing table of word ids, slot is Hash_Word & (size - 1) and probing is linear. (uint32_t, EMPTY_SLOT when empty)
+    WORD_TABLE,
+
+    // Word id to the X, Y of the words Position. (int32_t pairs)
+    POSITIONS,
+    // Word id to its Instances. (int32_t)
+    INSTANCES,
+    // Word id to its Importance. (float)
+    IMPORTANCE,
+    // Word id to its Complexity. (int32_t)
+    COMPLEXITY,
+
+    // The Cut_Buffer, Width * Width cells are the 2D map. (uint32_t)
+    CUT_BUFFER,
+    // The Cell_Offsets and Cells of the language, word id to its cells on the 2D map. (uint32_t)
+    CELL_OFFSETS,
+    CELLS,
+
+    // The arrays of the Next_Chain, as Finalize builds them, only its Mirror is empty.
+    NEXT_OFFSETS,
+    NEXT_TARGETS,
+    NEXT_COUNTS,
+    NEXT_PROBABILITIES,
+    NEXT_CUMULATIVE,
+    NEXT_COSTS,
+    NEXT_MIRROR,
+    NEXT_ALIAS_PROBABILITY,
+    NEXT_ALIAS,
+
+    // Same as above, for the Previus_Chain, where only the alias tables are empty.
+    PREVIUS_OFFSETS,
+    PREVIUS_TARGETS,
+    PREVIUS_COUNTS,
+    PREVIUS_PROBABILITIES,
+    PREVIUS_CUMULATIVE,
+    PREVIUS_COSTS,
+    PREVIUS_MIRROR,
+    PREVIUS_ALIAS_PROBABILITY,
+    PREVIUS_ALIAS,
+
+    // The Guides of the language, picked for the chains above, see Landmarks. (uint32_t, float, float)
+    // All three are empty when the language has no landmarks.
+    LANDMARK_WORDS,
+    LANDMARK_FROM,
+    LANDMARK_TO,
+
+    COUNT,
+};
+
+// The section Offset places after the given one, like NEXT_OFFSETS + 1 for NEXT_TARGETS.
+inline Snapshot_Section operator+(Snapshot_Section Section, uint32_t Offset){
+    return (Snapshot_Section)((uint32_t)Section + Offset);
+}
+
+// How many sections one Transition_Matrix takes, from NEXT_OFFSETS to NEXT_ALIAS.
+static constexpr uint32_t SNAPSHOT_MATRIX_SECTIONS = (uint32_t)Snapshot_Section::PREVIUS_OFFSETS - (uint32_t)Snapshot_Section::NEXT_OFFSETS;
+
+// Marks the empty slots of the WORD_TABLE.
+static constexpr uint32_t SNAPSHOT_EMPTY_SLOT = UINT32_MAX;
+
+class Snapshot_Header{
+public:
+    char Magic[8];
+    uint32_t Version;
+    // Always 0x01020304 when written, reads differently on a machine of the other byte order.
+    uint32_t Byte_Order;
+
+    uint64_t Word_Count;
+    uint64_t Cell_Count;
+    int64_t Width;
+
+    struct Range{
+        uint64_t Offset;
+        uint64_t Size;  // In bytes.
+    };
+
+    Range Sections[(size_t)Snapshot_Section::COUNT];
+
+    // Returns the header of the snapshot, or nullptr if the data is not a snapshot of this version, or the sections do not fit in it.
+    // Data has to be aligned to SNAPSHOT_ALIGNMENT, which memory mappings always are.
+    static const Snapshot_Header* Read(const char* Data, size_t Size);
+
+    template<typename T>
+    const T* Get(const char* Data, Snapshot_Section Section) const{
+        return (const T*)(Data + Sections[(size_t)Section].Offset);
+    }
+
+    template<typename T>
+    size_t Count(Snapshot_Section Section) const{
+        return Sections[(size_t)Section].Size / sizeof(T);
+    }
+};
+
+#endif
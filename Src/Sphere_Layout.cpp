@@ -0,0 +1,189 @@
+#include "Sphere_Layout.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Keyword_Affinity.h"
+#include "Parallel.h"
+
+using namespace std;
+
+static constexpr float PI = 3.14159265358979f;
+
+Sphere_Point Sphere_Layout::Fibonacci_Point(uint32_t i, uint32_t Count){
+    // Every point turns by the golden angle around the axis, while the height goes down in equal steps.
+    static const float Golden_Angle = PI * (3 - sqrt(5.0f));
+
+    float Z = 1 - (2 * (float)i + 1) / Count;
+    float Radius = sqrt(max(0.0f, 1 - Z * Z));
+    float Angle = Golden_Angle * (float)i;
+
+    return {Radius * cos(Angle), Radius * sin(Angle), Z};
+}
+
+void Sphere_Layout::Build(Transition_View Next, Transition_View Previus, const vector<uint32_t>& keywords, size_t Word_Count, uint32_t Point_Count){
+    Keywords = keywords;
+    Point_Count = max(Point_Count, 1u);
+
+    Points.resize(Point_Count);
+
+    for (uint32_t i = 0; i < Point_Count; i++){
+        Points[i] = Fibonacci_Point(i, Point_Count);
+    }
+
+    // About one point per bucket.
+    Rows = max(1, (int)round(sqrt(Point_Count / 2.0)));
+    Bucket_Size = PI / Rows;
+
+    Row_Buckets.assign(Rows + 1, 0);
+
+    for (int Row = 0; Row < Rows; Row++){
+        float Middle = (Row + 0.5f) * Bucket_Size - PI / 2;
+
+        Row_Buckets[Row + 1] = Row_Buckets[Row] + max(1, (int)round(2 * Rows * cos(Middle)));
+    }
+
+    auto Bucket_Of = [this](Sphere_Point Point){
+        int Row = clamp((int)((asin(clamp(Point.Z, -1.0f, 1.0f)) + PI / 2) / Bucket_Size), 0, Rows - 1);
+        int Columns = Row_Buckets[Row + 1] - Row_Buckets[Row];
+        int Column = (int)((atan2(Point.Y, Point.X) + PI) / (2 * PI) * Columns);
+
+        return Row_Buckets[Row] + clamp(Column, 0, Columns - 1);
+    };
+
+    uint32_t Bucket_Count = Row_Buckets[Rows];
+
+    Bucket_Offsets.assign(Bucket_Count + 1, 0);
+    Bucket_Points.resize(Point_Count);
+
+    vector<uint32_t> Point_Buckets(Point_Count);
+
+    for (uint32_t i = 0; i < Point_Count; i++){
+        Point_Buckets[i] = Bucket_Of(Points[i]);
+        Bucket_Offsets[Point_Buckets[i] + 1]++;
+    }
+
+    for (uint32_t Bucket = 0; Bucket < Bucket_Count; Bucket++){
+        Bucket_Offsets[Bucket + 1] += Bucket_Offsets[Bucket];
+    }
+
+    vector<uint32_t> Cursor(Bucket_Offsets.begin(), Bucket_Offsets.end() - 1);
+
+    for (uint32_t i = 0; i < Point_Count; i++){
+        Bucket_Points[Cursor[Point_Buckets[i]]++] = i;
+    }
+
+    // The keywords are spread as evenly as the points of their own Fibonacci sphere are.
+    vector<Sphere_Point> Directions(Keywords.size());
+    vector<int32_t> Keyword_Index = Index_Keywords(Keywords, Word_Count);
+
+    for (size_t k = 0; k < Keywords.size(); k++){
+        Directions[k] = Fibonacci_Point((uint32_t)k, (uint32_t)Keywords.size());
+    }
+
+    Word_Points.resize(Word_Count);
+
+    Parallel_For(Word_Count, [&](unsigned, size_t Begin, size_t End){
+        for (size_t ID = Begin; ID < End; ID++){
+            int32_t Own = Keyword_Index[ID];
+
+            if (Own >= 0){
+                Word_Points[ID] = Nearest(Directions[Own]);
+                continue;
+            }
+
+            Sphere_Point Sum;
+
+            // Every transition to or from a keyword pulls the word towards the direction of that keyword.
+            For_Each_Keyword_Link(Next, Previus, Keyword_Index, ID, [&](int32_t k, float Count){
+                Sum.X += Directions[k].X * Count;
+                Sum.Y += Directions[k].Y * Count;
+                Sum.Z += Directions[k].Z * Count;
+            });
+
+            float Length = sqrt(Sum.Dot(Sum));
+
+            // No keywords, or keywords pulling to opposite sides, give no direction.
+            if (Length < 1e-6f){
+                Word_Points[ID] = ID % Point_Count;
+                continue;
+            }
+
+            Word_Points[ID] = Nearest({Sum.X / Length, Sum.Y / Length, Sum.Z / Length});
+        }
+    });
+
+    // Group the words by their point, the same way the buckets were made.
+    Point_Offsets.assign(Point_Count + 1, 0);
+    Words.resize(Word_Count);
+
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        Point_Offsets[Word_Points[ID] + 1]++;
+    }
+
+    for (uint32_t i = 0; i < Point_Count; i++){
+        Point_Offsets[i + 1] += Point_Offsets[i];
+    }
+
+    Cursor.assign(Point_Offsets.begin(), Point_Offsets.end() - 1);
+
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        Words[Cursor[Word_Points[ID]]++] = (uint32_t)ID;
+    }
+}
+
+uint32_t Sphere_Layout::Nearest(Sphere_Point Direction) const{
+    float Latitude = asin(clamp(Direction.Z, -1.0f, 1.0f));
+    float Longitude = atan2(Direction.Y, Direction.X);
+
+    uint32_t Best = 0;
+    float Best_Dot = -2;
+
+    for (float Radius = Bucket_Size; ; Radius *= 2){
+        int First_Row = max(0, (int)floor((Latitude - Radius + PI / 2) / Bucket_Size));
+        int Last_Row = min(Rows - 1, (int)floor((Latitude + Radius + PI / 2) / Bucket_Size));
+
+        for (int Row = First_Row; Row <= Last_Row; Row++){
+            int Columns = Row_Buckets[Row + 1] - Row_Buckets[Row];
+            float Column_Size = 2 * PI / Columns;
+
+            // The rows narrow towards the poles, so the same Radius spans more longitude in them.
+            // The widest span is at the latitude of the row closest to its pole.
+            float Low = Row * Bucket_Size - PI / 2;
+            float Narrowest = cos(max(fabs(Low), fabs(Low + Bucket_Size)));
+
+            int First_Column = 0;
+            int Last_Column = Columns - 1;
+
+            if (Radius < PI / 2 && sin(Radius) < Narrowest){
+                float Span = asin(sin(Radius) / Narrowest);
+
+                int First = (int)floor((Longitude - Span + PI) / Column_Size);
+                int Last = (int)floor((Longitude + Span + PI) / Column_Size);
+
+                if (Last - First + 1 < Columns){
+                    First_Column = First;
+                    Last_Column = Last;
+                }
+            }
+
+            for (int Column = First_Column; Column <= Last_Column; Column++){
+                // The columns wrap around at longitude pi.
+                int Bucket = Row_Buckets[Row] + (Column % Columns + Columns) % Columns;
+
+                for (uint32_t i = Bucket_Offsets[Bucket]; i < Bucket_Offsets[Bucket + 1]; i++){
+                    float Dot = Direction.Dot(Points[Bucket_Points[i]]);
+
+                    if (Dot > Best_Dot){
+                        Best_Dot = Dot;
+                        Best = Bucket_Points[i];
+                    }
+                }
+            }
+        }
+
+        // Every point within the Radius was looked at, so a point that close is the nearest one.
+        if (Best_Dot >= cos(Radius) || Radius >= PI)
+            return Best;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef _SPHERE_LAYOUT_H_
+#define _SPHERE_LAYOUT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Array_View.h"
+#include "Transition_Matrix.h"
+
+using namespace std;
+
+// Point on the unit sphere.
+class Sphere_Point{
+public:
+    float X = 0;
+    float Y = 0;
+    float Z = 0;
+
+    Sphere_Point(){}
+    Sphere_Point(float X, float Y, float Z) : X(X), Y(Y), Z(Z) {}
+
+    // The cosine of the angle between two points, the bigger the closer they are.
+    float Dot(Sphere_Point Other) const{
+        return X * Other.X + Y * Other.Y + Z * Other.Z;
+    }
+};
+
+// Low resolution layout of the words on a sphere, made out of Point_Count points of a Fibonacci sphere.
+// The Fibonacci sphere spirals from pole to pole, so every point covers close to the same area.
+// The keywords are spread evenly over the sphere, as the points of a Fibonacci sphere of their own, and take the point nearest to them.
+// Every other word takes the point nearest to the mean direction of the keywords it has transitions to or from, weighted by their counts.
+// Words with no keyword next to them are spread over the points by their id.
+// Only the points and the point of every word are stored, so the memory is small and doesn't depend on any map size.
+class Sphere_Layout{
+public:
+    vector<Sphere_Point> Points;
+
+    // The points bucketed by their latitude and longitude, each row of buckets is Bucket_Size radians high.
+    // The rows get fewer buckets towards the poles, so that every bucket covers about the same area, and about one point.
+    // Row 0 is the south pole, and the first bucket of a row starts at longitude -pi.
+    int Rows = 0;
+    float Bucket_Size = 0;
+    // Row to its first bucket, with one extra for the end of the last row.
+    vector<uint32_t> Row_Buckets;
+    vector<uint32_t> Bucket_Offsets;
+    vector<uint32_t> Bucket_Points;
+
+    // Keyword index to the word id.
+    vector<uint32_t> Keywords;
+
+    // Word id to the index of its point.
+    vector<uint32_t> Word_Points;
+
+    // Point index to where its words start in the Words, with one extra offset for the end of the last point.
+    vector<uint32_t> Point_Offsets;
+    // All the word ids by their point, ties in id order.
+    vector<uint32_t> Words;
+
+    // The i'th of Count points of a Fibonacci sphere.
+    static Sphere_Point Fibonacci_Point(uint32_t i, uint32_t Count);
+
+    // Lays out Word_Count words on a sphere of Point_Count points.
+    // Either chain can be left empty.
+    void Build(Transition_View Next, Transition_View Previus, const vector<uint32_t>& Keywords, size_t Word_Count, uint32_t Point_Count);
+
+    // Returns the index of the point closest to the Direction, which has to be of unit length.
+    // Looks at the buckets around the direction first, and only widens the search if nothing closer than them was found.
+    uint32_t Nearest(Sphere_Point Direction) const;
+
+    // The words on the point.
+    Array_View<uint32_t> Find(uint32_t Point) const{
+        return {Words.data() + Point_Offsets[Point], Point_Offsets[Point + 1] - Point_Offsets[Point]};
+    }
+};
+
+#endif
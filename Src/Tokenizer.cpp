@@ -0,0 +1,202 @@
+#include "Tokenizer.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TOKENIZER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang need to be told which functions may use the wider instructions.
+// MSVC allows the intrinsics everywhere.
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define TARGET_AVX2
+#define TARGET_SSSE3
+#endif
+
+using namespace std;
+
+const array<Byte_Class, 256> Byte_Classes = [](){
+    array<Byte_Class, 256> Result;
+    Result.fill(Byte_Class::WORD);
+
+    // Line endings separate words just like spaces do.
+    for (unsigned char c : string_view(" \t\n\r"))
+        Result[c] = Byte_Class::SPACE;
+
+    for (unsigned char c : string_view(",:().!?\"'-+*;[]{}"))
+        Result[c] = Byte_Class::DELIMITER;
+
+    return Result;
+}();
+
+const char* Find_Delimiter_Scalar(const char* Start, const char* End){
+    while (Start < End && Byte_Classes[(unsigned char)*Start] == Byte_Class::WORD)
+        Start++;
+
+    return Start;
+}
+
+#ifdef TOKENIZER_X86
+
+// The SIMD scanners split every byte into its high and low nibble and look both up from a 16 byte table.
+// Every high nibble that has delimiters in it gets its own bit, and the low nibble table marks which of those high nibbles the low nibble is a delimiter with.
+// A byte is then a delimiter exactly when the two looked up values share a bit.
+// This only works as long as the delimiters use at most 8 different high nibbles.
+struct Nibble_Tables{
+    alignas(32) uint8_t Low[32] = {};
+    alignas(32) uint8_t High[32] = {};
+    bool Usable = true;
+
+    Nibble_Tables(){
+        int Next_Bit = 0;
+
+        for (int High_Nibble = 0; High_Nibble < 16; High_Nibble++){
+            bool Used = false;
+
+            for (int Low_Nibble = 0; Low_Nibble < 16; Low_Nibble++){
+                if (Byte_Classes[High_Nibble << 4 | Low_Nibble] == Byte_Class::WORD)
+                    continue;
+
+                if (!Used){
+                    if (Next_Bit == 8){
+                        Usable = false;
+                        return;
+                    }
+
+                    High[High_Nibble] = 1 << Next_Bit++;
+                    Used = true;
+                }
+
+                Low[Low_Nibble] |= High[High_Nibble];
+            }
+        }
+
+        // AVX2 shuffles each 16 byte lane on its own, so both lanes need the same table.
+        memcpy(Low + 16, Low, 16);
+        memcpy(High + 16, High, 16);
+    }
+};
+
+const Nibble_Tables& Get_Nibble_Tables(){
+    static const Nibble_Tables Tables;
+    return Tables;
+}
+
+int Count_Trailing_Zeros(uint32_t Mask){
+#ifdef _MSC_VER
+    unsigned long Index;
+    _BitScanForward(&Index, Mask);
+    return (int)Index;
+#else
+    return __builtin_ctz(Mask);
+#endif
+}
+
+TARGET_AVX2 const char* Find_Delimiter_AVX2(const char* Start, const char* End){
+    const Nibble_Tables& Tables = Get_Nibble_Tables();
+
+    const __m256i Low_Table = _mm256_load_si256((const __m256i*)Tables.Low);
+    const __m256i High_Table = _mm256_load_si256((const __m256i*)Tables.High);
+    const __m256i Nibble_Mask = _mm256_set1_epi8(0x0F);
+    const __m256i Zero = _mm256_setzero_si256();
+
+    while (End - Start >= 32){
+        __m256i Bytes = _mm256_loadu_si256((const __m256i*)Start);
+
+        __m256i Low = _mm256_shuffle_epi8(Low_Table, _mm256_and_si256(Bytes, Nibble_Mask));
+        __m256i High = _mm256_shuffle_epi8(High_Table, _mm256_and_si256(_mm256_srli_epi16(Bytes, 4), Nibble_Mask));
+
+        // Bytes whose lookups share no bit are word bytes.
+        uint32_t Word_Bytes = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(Low, High), Zero));
+
+        if (Word_Bytes != 0xFFFFFFFFu)
+            return Start + Count_Trailing_Zeros(~Word_Bytes);
+
+        Start += 32;
+    }
+
+    return Find_Delimiter_Scalar(Start, End);
+}
+
+TARGET_SSSE3 const char* Find_Delimiter_SSSE3(const char* Start, const char* End){
+    const Nibble_Tables& Tables = Get_Nibble_Tables();
+
+    const __m128i Low_Table = _mm_load_si128((const __m128i*)Tables.Low);
+    const __m128i High_Table = _mm_load_si128((const __m128i*)Tables.High);
+    const __m128i Nibble_Mask = _mm_set1_epi8(0x0F);
+    const __m128i Zero = _mm_setzero_si128();
+
+    while (End - Start >= 16){
+        __m128i Bytes = _mm_loadu_si128((const __m128i*)Start);
+
+        __m128i Low = _mm_shuffle_epi8(Low_Table, _mm_and_si128(Bytes, Nibble_Mask));
+        __m128i High = _mm_shuffle_epi8(High_Table, _mm_and_si128(_mm_srli_epi16(Bytes, 4), Nibble_Mask));
+
+        uint32_t Word_Bytes = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(Low, High), Zero));
+
+        if (Word_Bytes != 0xFFFFu)
+            return Start + Count_Trailing_Zeros(~Word_Bytes);
+
+        Start += 16;
+    }
+
+    return Find_Delimiter_Scalar(Start, End);
+}
+
+bool Has_AVX2(){
+#ifdef _MSC_VER
+    int Info[4];
+
+    // The OS needs to save the wide registers too, not just the CPU support them.
+    __cpuid(Info, 1);
+    bool OS_Saves_YMM = (Info[2] & (1 << 27)) && (Info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+
+    __cpuidex(Info, 7, 0);
+    return OS_Saves_YMM && (Info[1] & (1 << 5));
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool Has_SSSE3(){
+#ifdef _MSC_VER
+    int Info[4];
+    __cpuid(Info, 1);
+    return Info[2] & (1 << 9);
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+#endif
+
+// Picks the widest scanner this CPU can run, once.
+const char* (*Pick_Scanner())(const char*, const char*){
+#ifdef TOKENIZER_X86
+    if (Get_Nibble_Tables().Usable){
+        if (Has_AVX2())
+            return Find_Delimiter_AVX2;
+
+        if (Has_SSSE3())
+            return Find_Delimiter_SSSE3;
+    }
+#endif
+
+    return Find_Delimiter_Scalar;
+}
+
+const char* Find_Delimiter(const char* Start, const char* End){
+    static const auto Scanner = Pick_Scanner();
+
+    return Scanner(Start, End);
+}
@@ -0,0 +1,54 @@
+#ifndef _TOKENIZER_H_
+#define _TOKENIZER_H_
+
+#include <array>
+#include <string_view>
+
+using namespace std;
+
+// What a byte means to the tokenizer.
+enum class Byte_Class : unsigned char{
+    WORD,       // Part of a word.
+    SPACE,      // Ends a word and is thrown away.
+    DELIMITER,  // Ends a word and is a word of its own, like '.' or '('.
+};
+
+// One entry for every byte value, so classifying a byte is a single load.
+extern const array<Byte_Class, 256> Byte_Classes;
+
+// Returns the first byte in [Start, End) that is not a word byte, or End if there is none.
+// Uses 32 or 16 bytes wide SIMD scanning when the CPU supports it.
+const char* Find_Delimiter(const char* Start, const char* End);
+
+// Cuts the buffer into words and delimiters, and gives each of them to Emit as a slice of the buffer.
+// The word still running at the end of the buffer is not emitted, but returned instead.
+// This way the caller can either continue it with the next buffer, or emit it as the last word.
+template<typename F>
+string_view Tokenize(string_view Buffer, F Emit){
+    const char* Current = Buffer.data();
+    const char* End = Current + Buffer.size();
+
+    while (Current < End){
+        const char* Word_End = Find_Delimiter(Current, End);
+
+        if (Word_End == End)
+            return string_view(Current, End - Current);
+
+        if (Word_End > Current)
+            Emit(string_view(Current, Word_End - Current));
+
+        // Delimiter runs are usually a byte or two, so they are walked one by one.
+        while (Word_End < End && Byte_Classes[(unsigned char)*Word_End] != Byte_Class::WORD){
+            if (Byte_Classes[(unsigned char)*Word_End] == Byte_Class::DELIMITER)
+                Emit(string_view(Word_End, 1));
+
+            Word_End++;
+        }
+
+        Current = Word_End;
+    }
+
+    return string_view(End, 0);
+}
+
+#endif
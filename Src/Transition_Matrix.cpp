@@ -0,0 +1,247 @@
+#include "Transition_Matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "Parallel.h"
+
+using namespace std;
+
+// Spreads the packed pair over the table, the plain pair would cluster up since ids are small and dense.
+uint64_t Hash_Edge(uint64_t Key){
+    Key ^= Key >> 33;
+    Key *= 0xff51afd7ed558ccdull;
+    Key ^= Key >> 33;
+    return Key;
+}
+
+void Edge_Table::Add(uint64_t Key, uint64_t Hash, uint32_t Count){
+    // Keep the table at most 3/4 full, so the probe chains stay short.
+    if ((Size + 1) * 4 > Keys.size() * 3)
+        Grow();
+
+    size_t Mask = Keys.size() - 1;
+
+    for (size_t i = Hash & Mask; ; i = (i + 1) & Mask){
+        if (Keys[i] == Key){
+            Counts[i] += Count;
+            return;
+        }
+
+        if (Keys[i] == EMPTY){
+            Keys[i] = Key;
+            Counts[i] = Count;
+            Size++;
+            return;
+        }
+    }
+}
+
+void Edge_Table::Grow(){
+    vector<uint64_t> Old_Keys = move(Keys);
+    vector<uint32_t> Old_Counts = move(Counts);
+
+    Keys.assign(max<size_t>(Old_Keys.size() * 2, 64), EMPTY);
+    Counts.assign(Keys.size(), 0);
+    Size = 0;
+
+    size_t Mask = Keys.size() - 1;
+
+    for (size_t Old = 0; Old < Old_Keys.size(); Old++){
+        if (Old_Keys[Old] == EMPTY)
+            continue;
+
+        size_t i = Hash_Edge(Old_Keys[Old]) & Mask;
+        while (Keys[i] != EMPTY)
+            i = (i + 1) & Mask;
+
+        Keys[i] = Old_Keys[Old];
+        Counts[i] = Old_Counts[Old];
+        Size++;
+    }
+}
+
+// The top bits of the hash pick the shard, the low bits the slot within it.
+size_t Get_Shard(uint64_t Hash){
+    return Hash >> 58;
+}
+
+void Edge_Counter::Add(uint32_t From, uint32_t To, uint32_t Count){
+    uint64_t Key = Pack(From, To);
+    uint64_t Hash = Hash_Edge(Key);
+
+    Shards[Get_Shard(Hash)].Add(Key, Hash, Count);
+}
+
+void Edge_Counter::Merge(Edge_Counter& Other, size_t Shard){
+    Edge_Table& From = Other.Shards[Shard];
+
+    for (size_t i = 0; i < From.Keys.size(); i++){
+        if (From.Keys[i] != Edge_Table::EMPTY)
+            Shards[Shard].Add(From.Keys[i], Hash_Edge(From.Keys[i]), From.Counts[i]);
+    }
+}
+
+void Transition_Matrix::Build(Edge_Counter& Edges, size_t Word_Count, bool Reverse){
+    Offsets.assign(Word_Count + 1, 0);
+
+    // First pass, count the length of each row.
+    Edges.For_Each([&](uint64_t Key, uint32_t){
+        uint32_t Row = Reverse ? Edge_Counter::Get_To(Key) : Edge_Counter::Get_From(Key);
+        Offsets[Row + 1]++;
+    });
+
+    partial_sum(Offsets.begin(), Offsets.end(), Offsets.begin());
+
+    Targets.resize(Offsets.back());
+    Counts.resize(Offsets.back());
+
+    // Second pass, fill the rows.
+    vector<uint32_t> Cursor(Offsets.begin(), Offsets.end() - 1);
+
+    Edges.For_Each([&](uint64_t Key, uint32_t Count){
+        uint32_t From = Edge_Counter::Get_From(Key);
+        uint32_t To = Edge_Counter::Get_To(Key);
+
+        if (Reverse)
+            swap(From, To);
+
+        uint32_t Edge = Cursor[From]++;
+        Targets[Edge] = To;
+        Counts[Edge] = Count;
+    });
+
+    // The hash table gives the edges in no particular order, so sort the rows by target.
+    // This makes the layout the same from run to run and lets Find binary search.
+    // Rows do not share anything, so each thread sorts its own range of them.
+    Parallel_For(Word_Count, [&](unsigned, size_t First, size_t Last){
+        vector<pair<uint32_t, uint32_t>> Row;
+
+        for (size_t ID = First; ID < Last; ID++){
+            uint32_t Begin = Offsets[ID];
+            uint32_t End = Offsets[ID + 1];
+
+            Row.clear();
+            for (uint32_t Edge = Begin; Edge < End; Edge++)
+                Row.push_back({Targets[Edge], Counts[Edge]});
+
+            sort(Row.begin(), Row.end());
+
+            for (uint32_t Edge = Begin; Edge < End; Edge++){
+                Targets[Edge] = Row[Edge - Begin].first;
+                Counts[Edge] = Row[Edge - Begin].second;
+            }
+        }
+    });
+}
+
+void Transition_Matrix::Normalize(){
+    Probabilities.resize(Counts.size());
+    Cumulative.resize(Counts.size());
+    Costs.resize(Counts.size());
+
+    Parallel_For(Offsets.size() - 1, [&](unsigned, size_t First, size_t Last){
+        for (size_t ID = First; ID < Last; ID++){
+            uint32_t Begin = Offsets[ID];
+            uint32_t End = Offsets[ID + 1];
+
+            if (Begin == End)
+                continue;
+
+            // Sums in 64 bits, so the counts of very common words cannot overflow.
+            uint64_t Sum = 0;
+            for (uint32_t Edge = Begin; Edge < End; Edge++)
+                Sum += Counts[Edge];
+
+            // Plain loops over the row without branches, so the compiler can vectorize them.
+            float Inverse = 1.0f / (float)Sum;
+            for (uint32_t Edge = Begin; Edge < End; Edge++)
+                Probabilities[Edge] = Counts[Edge] * Inverse;
+
+            float Running = 0;
+            for (uint32_t Edge = Begin; Edge < End; Edge++){
+                Running += Probabilities[Edge];
+                Cumulative[Edge] = Running;
+            }
+
+            // Rounding can leave the sum a hair off, which would let a sample fall past the row.
+            Cumulative[End - 1] = 1.0f;
+
+            for (uint32_t Edge = Begin; Edge < End; Edge++)
+                Costs[Edge] = -log(Probabilities[Edge]);
+        }
+    });
+}
+
+void Transition_Matrix::Build_Alias(){
+    Alias_Probability.resize(Probabilities.size());
+    Alias.resize(Probabilities.size());
+
+    Parallel_For(Offsets.size() - 1, [&](unsigned, size_t First, size_t Last){
+        // Work lists of the row indicies whose scaled probability is under and over the average.
+        vector<uint32_t> Small;
+        vector<uint32_t> Large;
+        vector<float> Scaled;
+
+        for (size_t ID = First; ID < Last; ID++){
+            uint32_t Begin = Offsets[ID];
+            uint32_t Degree = Offsets[ID + 1] - Begin;
+
+            Small.clear();
+            Large.clear();
+            Scaled.resize(Degree);
+
+            for (uint32_t i = 0; i < Degree; i++){
+                Scaled[i] = Probabilities[Begin + i] * Degree;
+
+                if (Scaled[i] < 1)
+                    Small.push_back(i);
+                else
+                    Large.push_back(i);
+            }
+
+            // Each small column is topped up to 1 from a large one.
+            while (Small.size() > 0 && Large.size() > 0){
+                uint32_t Less = Small.back();
+                uint32_t More = Large.back();
+                Small.pop_back();
+
+                Alias_Probability[Begin + Less] = Scaled[Less];
+                Alias[Begin + Less] = More;
+
+                Scaled[More] -= 1 - Scaled[Less];
+
+                if (Scaled[More] < 1){
+                    Large.pop_back();
+                    Small.push_back(More);
+                }
+            }
+
+            // What is left over is 1 up to rounding errors.
+            for (auto i : Large){
+                Alias_Probability[Begin + i] = 1;
+                Alias[Begin + i] = i;
+            }
+
+            for (auto i : Small){
+                Alias_Probability[Begin + i] = 1;
+                Alias[Begin + i] = i;
+            }
+        }
+    });
+}
+
+void Transition_Matrix::Link_Mirror(Transition_Matrix& Forward){
+    Mirror.resize(Targets.size());
+
+    // Walking the forward rows in id order visits the reversed rows in their target order too.
+    // So every reversed row can be filled front to back with a cursor, no searching needed.
+    vector<uint32_t> Cursor(Offsets.begin(), Offsets.end() - 1);
+
+    for (uint32_t From = 0; From + 1 < Forward.Offsets.size(); From++){
+        for (uint32_t Edge = Forward.Offsets[From]; Edge < Forward.Offsets[From + 1]; Edge++){
+            Mirror[Cursor[Forward.Targets[Edge]]++] = Edge;
+        }
+    }
+}
@@ -0,0 +1,201 @@
+#ifndef _TRANSITION_MATRIX_H_
+#define _TRANSITION_MATRIX_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Array_View.h"
+#include "Random.h"
+
+using namespace std;
+
+// Open addressing table from a packed pair of word ids to how many times the pair was seen.
+// Each count is a single probe in the usual case.
+class Edge_Table{
+public:
+    static constexpr uint64_t EMPTY = UINT64_MAX;
+
+    vector<uint64_t> Keys;
+    vector<uint32_t> Counts;
+
+    // How many of the slots are in use.
+    size_t Size = 0;
+
+    // Hash is the Hash_Edge of the Key.
+    void Add(uint64_t Key, uint64_t Hash, uint32_t Count);
+
+    void Grow();
+};
+
+// Counts how many times one word was followed by another, while the language is still being built.
+// The pairs are spread over Edge_Tables by their hash, so counters filled on different threads can be merged one shard per thread, without locking.
+class Edge_Counter{
+public:
+    static constexpr size_t SHARDS = 64;
+
+    vector<Edge_Table> Shards = vector<Edge_Table>(SHARDS);
+
+    void Add(uint32_t From, uint32_t To, uint32_t Count = 1);
+
+    // Adds every count of the other counters shard into this counters same shard.
+    void Merge(Edge_Counter& Other, size_t Shard);
+
+    static uint64_t Pack(uint32_t From, uint32_t To){
+        return (uint64_t)From << 32 | To;
+    }
+
+    static uint32_t Get_From(uint64_t Key){
+        return (uint32_t)(Key >> 32);
+    }
+
+    static uint32_t Get_To(uint64_t Key){
+        return (uint32_t)Key;
+    }
+
+    // Calls Function(Key, Count) for every counted pair.
+    template<typename F>
+    void For_Each(F Function){
+        for (auto& Shard : Shards){
+            for (size_t i = 0; i < Shard.Keys.size(); i++){
+                if (Shard.Keys[i] != Edge_Table::EMPTY)
+                    Function(Shard.Keys[i], Shard.Counts[i]);
+            }
+        }
+    }
+};
+
+// Read only Transition_Matrix over arrays owned by someone else, like a memory mapped snapshot.
+// All the reading of a matrix lives here, so it works the same no matter where the arrays are.
+// See Transition_Matrix for what the arrays hold.
+class Transition_View{
+public:
+    Array_View<uint32_t> Offsets;
+    Array_View<uint32_t> Targets;
+    Array_View<uint32_t> Counts;
+    Array_View<float> Probabilities;
+    Array_View<float> Cumulative;
+    Array_View<float> Costs;
+    Array_View<uint32_t> Mirror;
+    Array_View<float> Alias_Probability;
+    Array_View<uint32_t> Alias;
+
+    uint32_t Degree(uint32_t ID) const{
+        return Offsets[ID + 1] - Offsets[ID];
+    }
+
+    // Picks a target from the row with its probability, given a uniform random number in [0, 1).
+    // Binary searches the cumulative row, so this is O(log degree).
+    // Returns UINT32_MAX if the word has no edges.
+    uint32_t Sample(uint32_t ID, float Uniform) const{
+        const float* Begin = Cumulative.begin() + Offsets[ID];
+        const float* End = Cumulative.begin() + Offsets[ID + 1];
+
+        if (Begin == End)
+            return UINT32_MAX;
+
+        const float* Result = upper_bound(Begin, End, Uniform);
+
+        if (Result == End)
+            Result--;
+
+        return Targets[Result - Cumulative.begin()];
+    }
+
+    // Same as Sample, but through the alias table, so it is O(1) no matter how many edges the word has.
+    uint32_t Sample_Alias(uint32_t ID, Random& Generator) const{
+        uint32_t Begin = Offsets[ID];
+        uint32_t Degree = Offsets[ID + 1] - Begin;
+
+        if (Degree == 0)
+            return UINT32_MAX;
+
+        // One random number is enough, the high half picks the column and the low bits the coin.
+        uint64_t Bits = Generator.Next();
+        uint32_t Column = (uint32_t)(((Bits >> 32) * Degree) >> 32);
+        float Coin = (Bits & 0xFFFFFF) * (1.0f / (1 << 24));
+
+        uint32_t Edge = Begin + Column;
+
+        if (Coin < Alias_Probability[Edge])
+            return Targets[Edge];
+
+        return Targets[Begin + Alias[Edge]];
+    }
+
+    // Returns the edge index from the word to the target, or UINT32_MAX if there is none.
+    uint32_t Find(uint32_t ID, uint32_t Target) const{
+        const uint32_t* Begin = Targets.begin() + Offsets[ID];
+        const uint32_t* End = Targets.begin() + Offsets[ID + 1];
+
+        const uint32_t* Result = lower_bound(Begin, End, Target);
+
+        if (Result == End || *Result != Target)
+            return UINT32_MAX;
+
+        return (uint32_t)(Result - Targets.begin());
+    }
+};
+
+// Compressed sparse row matrix of the word transitions.
+// The row of a word is its edges [Offsets[ID], Offsets[ID + 1]) in Targets and Counts, ordered by the target id.
+// Built once from an Edge_Counter, after which walking a row is a linear scan over two arrays.
+class Transition_Matrix{
+public:
+    vector<uint32_t> Offsets;
+    vector<uint32_t> Targets;
+    vector<uint32_t> Counts;
+
+    // The counts of each row divided by the row total, and their running sum within the row.
+    // The last cumulative value of a row is always exactly 1.
+    vector<float> Probabilities;
+    vector<float> Cumulative;
+
+    // -log of the Probabilities, the cost of stepping over the edge when searching for the most probable path.
+    vector<float> Costs;
+
+    // Only in a reversed matrix, the index of the same edge in the forward matrix.
+    // Lets a backwards walk use the forward probabilities.
+    vector<uint32_t> Mirror;
+
+    // Walker/Vose alias table of each row, parallel to the edges.
+    // Edge e of a row keeps its own target with Alias_Probability[e], and otherwise gives the edge at row index Alias[e].
+    vector<float> Alias_Probability;
+    vector<uint32_t> Alias;
+
+    // Two passes over the counted pairs, first counts how long each row is and then fills the rows.
+    // When Reverse is set, the rows are the targets of the counted pairs, so each row lists the words that came before it.
+    void Build(Edge_Counter& Edges, size_t Word_Count, bool Reverse);
+
+    // Fills the Probabilities, Cumulative and Costs from the Counts.
+    void Normalize();
+
+    // The matrix as a Transition_View, which is what the searches and samplers read.
+    operator Transition_View() const{
+        return {Offsets, Targets, Counts, Probabilities, Cumulative, Costs, Mirror, Alias_Probability, Alias};
+    }
+
+    uint32_t Sample(uint32_t ID, float Uniform) const{
+        return Transition_View(*this).Sample(ID, Uniform);
+    }
+
+    // Builds the alias tables from the Probabilities.
+    void Build_Alias();
+
+    uint32_t Sample_Alias(uint32_t ID, Random& Generator) const{
+        return Transition_View(*this).Sample_Alias(ID, Generator);
+    }
+
+    // Fills the Mirror of this reversed matrix against the forward matrix built from the same Edge_Counter.
+    void Link_Mirror(Transition_Matrix& Forward);
+
+    uint32_t Degree(uint32_t ID) const{
+        return Offsets[ID + 1] - Offsets[ID];
+    }
+
+    uint32_t Find(uint32_t ID, uint32_t Target) const{
+        return Transition_View(*this).Find(ID, Target);
+    }
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "Vocabulary.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+uint32_t Vocabulary::Intern(string_view Word){
+    return Intern(Word, Hash_Word(Word));
+}
+
+uint32_t Vocabulary::Intern(string_view Word, uint64_t Hash){
+    if (uint32_t* Existing = Index.Find(Word, Hash))
+        return *Existing;
+
+    // Words longer than a block get a block of their own.
+    if (Blocks.size() == 0 || Block_Used + Word.size() > BLOCK_SIZE){
+        Blocks.push_back(make_unique<char[]>(max(BLOCK_SIZE, Word.size())));
+        Block_Used = 0;
+    }
+
+    char* Stored = Blocks.back().get() + Block_Used;
+    memcpy(Stored, Word.data(), Word.size());
+    Block_Used += Word.size();
+
+    uint32_t ID = (uint32_t)Words.size();
+
+    Words.push_back(string_view(Stored, Word.size()));
+    Hashes.push_back(Hash);
+    Index.Insert(Words.back(), Hash, ID);
+
+    return ID;
+}
+
+uint32_t Vocabulary::Find(string_view Word){
+    uint32_t* Existing = Index.Find(Word);
+
+    if (!Existing)
+        return NOT_FOUND;
+
+    return *Existing;
+}
+
+void Vocabulary::Load(string_view Characters, const uint64_t* Offsets, const uint64_t* Hashes, size_t Word_Count){
+    // All the words go into a single block of their own.
+    Blocks.push_back(make_unique<char[]>(max<size_t>(Characters.size(), 1)));
+    memcpy(Blocks.back().get(), Characters.data(), Characters.size());
+    Block_Used = BLOCK_SIZE;
+
+    const char* Stored = Blocks.back().get();
+
+    Words.resize(Word_Count);
+    this->Hashes.assign(Hashes, Hashes + Word_Count);
+    Index.Reserve(Word_Count);
+
+    for (size_t ID = 0; ID < Word_Count; ID++){
+        Words[ID] = string_view(Stored + Offsets[ID], Offsets[ID + 1] - Offsets[ID]);
+        Index.Insert(Words[ID], Hashes[ID], (uint32_t)ID);
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef _VOCABULARY_H_
+#define _VOCABULARY_H_
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "Flat_Map.h"
+
+using namespace std;
+
+// Stores every unique word once and hands out small integer ids for them.
+// The ids are given in the order the words are first seen, starting from 0.
+class Vocabulary{
+public:
+    // Returned by Find when the word has never been interned.
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    // Words are packed into big character blocks that never move.
+    // This way the views into them stay valid for as long as the vocabulary lives.
+    static constexpr size_t BLOCK_SIZE = 1 << 16;
+    vector<unique_ptr<char[]>> Blocks;
+    size_t Block_Used = BLOCK_SIZE;
+
+    // Id to word.
+    vector<string_view> Words;
+
+    // Id to the Hash_Word of the word, so other tables of words never need to hash them again.
+    vector<uint64_t> Hashes;
+
+    // Word to id, the keys point into the blocks.
+    Flat_Map<uint32_t> Index;
+
+    // Returns the id of the word, and stores it first if it is new.
+    uint32_t Intern(string_view Word);
+    // Same as above, when the Hash_Word of the word is already known.
+    uint32_t Intern(string_view Word, uint64_t Hash);
+
+    // Fills an empty vocabulary with Word_Count words packed back to back in Characters.
+    // Word id starts at Offsets[id] and ends at Offsets[id + 1], Hashes are the Hash_Word of the words.
+    void Load(string_view Characters, const uint64_t* Offsets, const uint64_t* Hashes, size_t Word_Count);
+
+    // Returns the id of the word, or NOT_FOUND.
+    uint32_t Find(string_view Word);
+
+    string_view Get(uint32_t ID){
+        return Words[ID];
+    }
+
+    size_t Size(){
+        return Words.size();
+    }
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "Src/DMC.h"
 
+#include <ctime>
 #include <iostream>
 #include <vector>
 
@@ -14,13 +15,12 @@ using namespace std;
 */
 
 int main(){
-    srand(time(NULL));
-    
     Language Lang("C:/Users/gagolzar/source/repos/DMC/Languages/text.txt");
     
     Teller t(&Lang);
+    t.Generator = Random(time(NULL));
     
-    //cout << t.Generate_Thought(123) << endl;
+    cout << t.Generate_Thought(123) << endl;
 
     
 